@@ -0,0 +1,86 @@
+/*
+    BENCHMARK: construção da árvore (heap × duas filas × package-merge)
+
+    Mede quanto tempo cada forma de obter os comprimentos dos códigos leva
+    para alguns histogramas típicos e confere que todas geram o mesmo
+    tamanho de saída (soma de frequência × comprimento).
+
+    Compilar: gcc -O2 benchmark_arvore.c -o benchmark_arvore -pthread
+    Rodar:    ./benchmark_arvore [repetições]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "huffman.h"
+#include "pqueue_heap.h"
+
+#define BENCH_REPETITIONS 20000
+
+double now_seconds() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+uint64_t total_bits(const uint64_t freq[256], const unsigned char lengths[256]) {
+    uint64_t bits = 0;
+    for (int s = 0; s < 256; s++) bits += freq[s] * lengths[s];
+    return bits;
+}
+
+// Histogramas de teste
+void make_histogram(int kind, uint64_t freq[256]) {
+    memset(freq, 0, 256 * sizeof(uint64_t));
+    srand(42);
+
+    switch (kind) {
+        case 0: //bytes aleatórios: 256 símbolos quase iguais
+            for (int s = 0; s < 256; s++) freq[s] = 4000 + rand() % 200;
+            break;
+        case 1: //texto: ~90 símbolos, frequências tipo Zipf
+            for (int s = 0; s < 90; s++) freq[32 + s] = 1000000 / (s + 1);
+            break;
+        case 2: //Fibonacci: árvore o mais funda possível
+            freq[0] = freq[1] = 1;
+            for (int s = 2; s < 40; s++) freq[s] = freq[s - 1] + freq[s - 2];
+            break;
+        default: //poucos símbolos
+            freq['A'] = 500; freq['C'] = 300; freq['G'] = 150; freq['T'] = 50;
+            break;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* names[] = {"aleatorio", "texto", "fibonacci", "4 simbolos"};
+    int repetitions = argc > 1 ? atoi(argv[1]) : BENCH_REPETITIONS;
+    if (repetitions <= 0) repetitions = BENCH_REPETITIONS;
+
+    printf("%-12s %14s %14s %14s   %s\n", "histograma", "heap (ns)", "2 filas (ns)", "pkg-merge (ns)", "bits iguais?");
+
+    for (int kind = 0; kind < 4; kind++) {
+        uint64_t freq[256];
+        unsigned char lengths[3][256];
+        double elapsed[3];
+        make_histogram(kind, freq);
+
+        //sem limite na comparação (32 bits): o package-merge calcula o mesmo ótimo
+        for (int method = 0; method < 3; method++) {
+            double start = now_seconds();
+            for (int r = 0; r < repetitions; r++) {
+                if (method == 0) huff_code_lengths(freq, 32, HUFF_BUILD_HEAP, lengths[0]);
+                if (method == 1) huff_code_lengths(freq, 32, HUFF_BUILD_TWO_QUEUE, lengths[1]);
+                if (method == 2) huff_limited_code_lengths(freq, 32, lengths[2]);
+            }
+            elapsed[method] = (now_seconds() - start) / repetitions * 1e9;
+        }
+
+        uint64_t bits = total_bits(freq, lengths[0]);
+        int same = bits == total_bits(freq, lengths[1]) && bits == total_bits(freq, lengths[2]);
+        printf("%-12s %14.0f %14.0f %14.0f   %s\n", names[kind], elapsed[0], elapsed[1], elapsed[2], same ? "sim" : "NAO");
+    }
+    return 0;
+}
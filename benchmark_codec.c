@@ -0,0 +1,498 @@
+/*
+    BENCHMARK: compactação e descompactação de ponta a ponta, todos os modos
+
+    Gera um corpus de teste numa pasta (só na primeira vez: arquivos que já
+    existem com o tamanho certo são reaproveitados) e, para cada arquivo e
+    cada modo, compacta, descompacta e confere o resultado:
+
+    aleatorio.bin   bytes uniformes (não comprime: mede o custo puro)
+    enviesado.bin   distribuição geométrica (poucos bytes dominam)
+    texto.txt       palavras de um vocabulário com frequências tipo Zipf
+    repetido.bin    um byte só
+    minusculo.txt   64 bytes de texto (o cabeçalho pesa mais que os bits)
+    pequeno.txt     1 KiB de texto
+    grande.txt      texto de -s MiB (padrão 256; use -s 4096 para 4 GiB)
+
+    Cada caso (arquivo × modo) roda num processo filho (fork): assim o pico
+    de memória (ru_maxrss) é só daquele caso. Arquivos pequenos são
+    processados várias vezes e vale a melhor rodada.
+
+    Para os modos original e canonical também sai o tempo de cada etapa
+    (frequências, árvore/códigos, cabeçalho, codificação, decodificação): o
+    original repete os passos da main, o canônico roda as mesmas funções de
+    compress_canonical() com tudo na memória.
+
+    Saída em JSON na saída padrão (o progresso vai para stderr):
+
+    {"threads": 8, "results": [
+      {"file": "texto.txt", "mode": "canonical", "size": ..., "compressed": ...,
+       "ratio": 0.56, "compress_mb_s": ..., "decompress_mb_s": ..., "peak_rss_kib": ...,
+       "roundtrip": true, "stages_ms": {"histogram": ..., "tree": ..., "header": ...,
+       "encode": ..., "decode": ...}}, ...]}
+
+    Compilado com -DHUFF_PROFILE (ver huff_profile.h), cada caso ganha também
+    "profile": os contadores de todas as etapas, somados em todas as rodadas.
+
+    Compilar: gcc -O2 benchmark_codec.c -o benchmark_codec -pthread
+    Rodar:    ./benchmark_codec [-s MiB do grande] [-d pasta] [-m modo,modo,...] [-r repetições] > resultado.json
+    Modos:    original, chunked, interleaved, canonical, stream, adaptive, order1, lz
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "huffman.h"
+#include "pqueue_heap.h"
+
+#define BENCH_LARGE_MIB 256
+#define BENCH_DIR "bench_corpus_v2" //v2: gerador trocado (os arquivos do v1 têm o mesmo tamanho e seriam reaproveitados)
+#define BENCH_REPETITIONS 5
+#define BENCH_MIN_BYTES (32 * 1024 * 1024) //arquivos pequenos repetem até processar ~32 MiB (no máximo 1000 vezes)
+#define BENCH_PATH 1024
+
+double now_seconds() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/*
+    GERAÇÃO DO CORPUS
+*/
+
+/*xorshift64*: rápido e igual em toda máquina (rand() muda de uma libc para outra).
+A multiplicação no fim mistura os bits: no xorshift64 puro o byte baixo de uma
+saída depende do da anterior, e o order-1 comprimia o "aleatório" para 0.876.*/
+static uint64_t bench_state = 42;
+static uint64_t bench_random() {
+    bench_state ^= bench_state >> 12;
+    bench_state ^= bench_state << 25;
+    bench_state ^= bench_state >> 27;
+    return bench_state * 0x2545F4914F6CDD1Dull;
+}
+
+typedef enum { GEN_RANDOM, GEN_SKEWED, GEN_TEXT, GEN_SAME } BenchGenerator;
+
+typedef struct {
+    const char* name;
+    BenchGenerator generator;
+    uint64_t size; //0 = o arquivo grande (-s)
+} BenchFile;
+
+static const BenchFile bench_files[] = {
+    {"aleatorio.bin", GEN_RANDOM, 16 << 20},
+    {"enviesado.bin", GEN_SKEWED, 16 << 20},
+    {"texto.txt", GEN_TEXT, 16 << 20},
+    {"repetido.bin", GEN_SAME, 16 << 20},
+    {"minusculo.txt", GEN_TEXT, 64},
+    {"pequeno.txt", GEN_TEXT, 1024},
+    {"grande.txt", GEN_TEXT, 0},
+};
+#define BENCH_FILE_COUNT (sizeof(bench_files) / sizeof(bench_files[0]))
+
+#define BENCH_WORDS 4096
+static char bench_vocabulary[BENCH_WORDS][12];
+
+static void make_vocabulary() {
+    for (int w = 0; w < BENCH_WORDS; w++) {
+        int length = 1 + (int)(bench_random() % 10);
+        for (int i = 0; i < length; i++) bench_vocabulary[w][i] = (char)('a' + bench_random() % 26);
+        bench_vocabulary[w][length] = '\0';
+    }
+}
+
+// Preenche block[0 .. n-1]. O texto continua de onde o bloco anterior parou (*pending)
+static void generate_block(BenchGenerator generator, unsigned char* block, size_t n, const char** pending) {
+    size_t i = 0;
+    switch (generator) {
+        case GEN_RANDOM:
+            for (; i < n; i++) block[i] = (unsigned char)(bench_random() >> 56); //os bits altos são os mais bem misturados
+            break;
+        case GEN_SKEWED: //zeros à esquerda de um número aleatório: metade das vezes 0, um quarto 1, ...
+            for (; i < n; i++) {
+                uint64_t r = bench_random();
+                block[i] = (unsigned char)(__builtin_clzll(r | 1) * 4 + (r & 3));
+            }
+            break;
+        case GEN_SAME:
+            memset(block, 'a', n);
+            break;
+        case GEN_TEXT:
+            while (i < n) {
+                if (**pending == '\0') {
+                    //u³ concentra as escolhas no começo do vocabulário (parecido com Zipf)
+                    double u = (bench_random() >> 11) * (1.0 / 9007199254740992.0);
+                    *pending = bench_vocabulary[(int)(u * u * u * BENCH_WORDS)];
+                    block[i++] = bench_random() % 12 == 0 ? '\n' : ' ';
+                    continue;
+                }
+                block[i++] = (unsigned char)*(*pending)++;
+            }
+            break;
+    }
+}
+
+// Cria o arquivo, a não ser que já exista com o tamanho certo. Retorna 1 se deu certo
+static int generate_file(const char* path, BenchGenerator generator, uint64_t size) {
+    struct stat info;
+    if (stat(path, &info) == 0 && (uint64_t)info.st_size == size) return 1;
+
+    FILE* file = fopen(path, "wb");
+    unsigned char* block = malloc(1 << 20);
+    if (!file || !block) {
+        perror(path);
+        if (file) fclose(file);
+        free(block);
+        return 0;
+    }
+
+    fprintf(stderr, "gerando %s (%llu bytes)\n", path, (unsigned long long)size);
+    bench_state = 42 + (uint64_t)generator;
+    const char* pending = "";
+    int ok = 1;
+    for (uint64_t done = 0; ok && done < size;) {
+        size_t n = size - done < (1 << 20) ? (size_t)(size - done) : (1 << 20);
+        generate_block(generator, block, n, &pending);
+        ok = fwrite(block, 1, n, file) == n;
+        done += n;
+    }
+    if (fclose(file) != 0) ok = 0;
+    free(block);
+    return ok;
+}
+
+/*
+    UM CASO (arquivo × modo)
+*/
+
+typedef enum { MODE_ORIGINAL, MODE_CHUNKED, MODE_INTERLEAVED, MODE_CANONICAL, MODE_STREAM, MODE_ADAPTIVE, MODE_ORDER1, MODE_LZ, MODE_COUNT } BenchMode;
+static const char* bench_mode_names[MODE_COUNT] = {"original", "chunked", "interleaved", "canonical", "stream", "adaptive", "order1", "lz"};
+
+enum { STAGE_HISTOGRAM, STAGE_TREE, STAGE_HEADER, STAGE_ENCODE, STAGE_DECODE, STAGE_COUNT };
+static const char* bench_stage_names[STAGE_COUNT] = {"histogram", "tree", "header", "encode", "decode"};
+
+// Os passos da opção 1 da main, cronometrados. Retorna 1 se deu certo
+static int compress_original_staged(FILE* input, FILE* output, double stages[STAGE_COUNT]) {
+    PRIORITY_QUEUE* huff_queue1 = create_queue();
+    PRIORITY_QUEUE* huff_queue2 = create_queue();
+    NODE_POOL* pool = create_node_pool();
+    if (pool == NULL) return 0;
+
+    double t0 = now_seconds();
+    create_huff_queue(input, &huff_queue1, &huff_queue2, pool);
+    double t1 = now_seconds();
+
+    NODE* root = build_huffman_tree(huff_queue1, pool);
+    HuffmanCode huff_table[256] = {0};
+    create_huffman_table(root, 0, 0, huff_table);
+    NODE* limited = limit_huffman_tree(root, huff_table, HUFF_MAX_CODE_LENGTH);
+    double t2 = now_seconds();
+    if (root && !limited) {
+        free_node_pool(pool);
+        free_priority_queue(huff_queue1);
+        free_priority_queue(huff_queue2);
+        return 0;
+    }
+    root = limited;
+
+    write_header(huff_queue2, huff_table, output, root);
+    double t3 = now_seconds();
+
+    rewind(input);
+    compactor(input, output, huff_table);
+    double t4 = now_seconds();
+
+    stages[STAGE_HISTOGRAM] = t1 - t0;
+    stages[STAGE_TREE] = t2 - t1;
+    stages[STAGE_HEADER] = t3 - t2;
+    stages[STAGE_ENCODE] = t4 - t3;
+
+    free_node_pool(pool);
+    free_priority_queue(huff_queue1);
+    free_priority_queue(huff_queue2);
+    return 1;
+}
+
+static int compress_mode(BenchMode mode, FILE* input, FILE* output, double stages[STAGE_COUNT]) {
+    switch (mode) {
+        case MODE_ORIGINAL:  return compress_original_staged(input, output, stages);
+        case MODE_CHUNKED:   return compress_chunked(input, output, HUFF_CHUNK_SIZE, 0, HUFF_CHUNK_CANONICAL);
+        case MODE_INTERLEAVED: return compress_chunked(input, output, HUFF_CHUNK_SIZE, 0, HUFF_CHUNK_INTERLEAVED);
+        case MODE_CANONICAL: return compress_canonical(input, output);
+        case MODE_STREAM:    return compress_stream(input, output, HUFF_STREAM_BLOCK_SIZE);
+        case MODE_ADAPTIVE:  return compress_adaptive(input, output);
+        case MODE_ORDER1:    return compress_order1(input, output);
+        case MODE_LZ:        return compress_lz(input, output, HUFF_LZ_DEFAULT_LEVEL);
+        default:             return 0;
+    }
+}
+
+// Abre os dois arquivos, roda compress_mode() ou decompress_file() e fecha. Retorna o tempo (< 0 se falhou)
+static double timed_run(int compress, BenchMode mode, const char* in_path, const char* out_path, double stages[STAGE_COUNT]) {
+    FILE* input = fopen(in_path, "rb");
+    FILE* output = fopen(out_path, compress ? "wb" : "w+b"); //descompactação: saída mapeada, igual a decompact()
+    if (!input || !output) {
+        perror(input ? out_path : in_path);
+        if (input) fclose(input);
+        if (output) fclose(output);
+        return -1;
+    }
+
+    double start = now_seconds();
+    int ok = compress ? compress_mode(mode, input, output, stages) : decompress_file(input, output);
+    if (fclose(output) != 0) ok = 0;
+    double elapsed = now_seconds() - start;
+    fclose(input);
+    return ok ? elapsed : -1;
+}
+
+// Compara os dois arquivos em blocos de 1 MiB
+static int same_contents(const char* path_a, const char* path_b) {
+    FILE* a = fopen(path_a, "rb");
+    FILE* b = fopen(path_b, "rb");
+    unsigned char* block_a = malloc(1 << 20);
+    unsigned char* block_b = malloc(1 << 20);
+    int same = a && b && block_a && block_b;
+
+    while (same) {
+        size_t got_a = fread(block_a, 1, 1 << 20, a);
+        size_t got_b = fread(block_b, 1, 1 << 20, b);
+        if (got_a != got_b || memcmp(block_a, block_b, got_a) != 0) same = 0;
+        if (got_a == 0) break;
+    }
+
+    if (a) fclose(a);
+    if (b) fclose(b);
+    free(block_a);
+    free(block_b);
+    return same;
+}
+
+static uint64_t file_size(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 ? (uint64_t)info.st_size : 0;
+}
+
+/*As etapas de compress_canonical()/decompress_canonical(), com o arquivo inteiro na
+memória (sem E/S no meio). Retorna 1 se deu certo.*/
+static int canonical_stages(const char* path, uint64_t size, double stages[STAGE_COUNT]) {
+    FILE* file = fopen(path, "rb");
+    unsigned char* data = malloc(size ? (size_t)size : 1);
+    HuffDecodeTable* table = malloc(sizeof(HuffDecodeTable));
+    HuffWriter packed, unpacked;
+    int ok = file && data && table && fread(data, 1, (size_t)size, file) == size;
+    if (file) fclose(file);
+
+    ok = ok && huff_writer_open_memory(&packed, (size_t)size + HUFF_CTX_HEADER_SLACK);
+    if (ok && !huff_writer_open_memory(&unpacked, size ? (size_t)size : 1)) {
+        huff_writer_close(&packed);
+        ok = 0;
+    }
+    if (!ok) {
+        free(data);
+        free(table);
+        return 0;
+    }
+
+    double t0 = now_seconds();
+    uint64_t freq[256] = {0};
+    count_frequencies(data, (size_t)size, freq);
+    double t1 = now_seconds();
+
+    HuffmanCode codes[256];
+    unsigned char lengths[256];
+    ok = huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths) && build_canonical_codes(lengths, codes);
+    double t2 = now_seconds();
+
+    write_canonical_header(&packed, size, lengths);
+    size_t header_size = packed.pos;
+    double t3 = now_seconds();
+
+    BitWriter bits = {0, 0};
+    huff_encode_block(data, (size_t)size, codes, &bits, &packed);
+    bit_writer_finish(&bits, &packed);
+    double t4 = now_seconds();
+
+    HuffReader reader;
+    huff_reader_open_memory(&reader, packed.data + header_size, packed.pos - header_size);
+    ok = ok && build_decode_table_from_lengths(lengths, table) &&
+         huff_decode_stream(&reader, &unpacked, table, INT64_MAX, size) == size &&
+         memcmp(unpacked.data, data, (size_t)size) == 0;
+    double t5 = now_seconds();
+    huff_reader_close(&reader);
+
+    stages[STAGE_HISTOGRAM] = t1 - t0;
+    stages[STAGE_TREE] = t2 - t1;
+    stages[STAGE_HEADER] = t3 - t2;
+    stages[STAGE_ENCODE] = t4 - t3;
+    stages[STAGE_DECODE] = t5 - t4;
+
+    huff_writer_close(&packed);
+    huff_writer_close(&unpacked);
+    free(data);
+    free(table);
+    return ok;
+}
+
+/*Roda um caso e imprime o objeto JSON dele. Chamado no processo filho:
+o pico de memória medido no fim é só deste caso.*/
+static void run_case(const char* dir, const char* name, BenchMode mode, int max_repetitions) {
+    char path[BENCH_PATH], packed_path[BENCH_PATH], unpacked_path[BENCH_PATH];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    snprintf(packed_path, sizeof(packed_path), "%s/%s.%s.huff", dir, name, bench_mode_names[mode]);
+    snprintf(unpacked_path, sizeof(unpacked_path), "%s/%s.%s.out", dir, name, bench_mode_names[mode]);
+
+    uint64_t size = file_size(path);
+    int repetitions = size > 0 && size < BENCH_MIN_BYTES ? (int)(BENCH_MIN_BYTES / size) : 1;
+    if (repetitions > max_repetitions) repetitions = max_repetitions;
+    if (repetitions > 1000) repetitions = 1000;
+    if (repetitions < 1) repetitions = 1;
+
+    double stages[STAGE_COUNT] = {0}, best_stages[STAGE_COUNT] = {0};
+    double best_compress = -1, best_decompress = -1;
+    int ok = 1;
+#ifdef HUFF_PROFILE
+    huff_profile_reset();
+#endif
+
+    for (int r = 0; ok && r < repetitions; r++) {
+        double compress_time = timed_run(1, mode, path, packed_path, stages);
+        double decompress_time = compress_time >= 0 ? timed_run(0, mode, packed_path, unpacked_path, NULL) : -1;
+        if (compress_time < 0 || decompress_time < 0) {
+            ok = 0;
+            break;
+        }
+        if (best_compress < 0 || compress_time < best_compress) {
+            best_compress = compress_time;
+            memcpy(best_stages, stages, sizeof(stages));
+        }
+        if (best_decompress < 0 || decompress_time < best_decompress) {
+            best_decompress = decompress_time;
+            best_stages[STAGE_DECODE] = decompress_time;
+        }
+    }
+
+    uint64_t compressed = file_size(packed_path);
+#ifdef HUFF_PROFILE
+    HuffStageStats profile[HUFF_STAGE_COUNT];
+    huff_profile_get(profile); //antes de same_contents() e canonical_stages(), que não fazem parte do caso
+#endif
+    int roundtrip = ok && same_contents(path, unpacked_path);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    remove(packed_path);
+    remove(unpacked_path);
+
+    int staged = mode == MODE_ORIGINAL || (mode == MODE_CANONICAL && canonical_stages(path, size, best_stages));
+    double mb = size / 1e6;
+
+    printf("    {\"file\": \"%s\", \"mode\": \"%s\", \"size\": %llu, \"compressed\": %llu, \"repetitions\": %d,\n",
+           name, bench_mode_names[mode], (unsigned long long)size, (unsigned long long)compressed, repetitions);
+    printf("     \"ratio\": %.4f, \"compress_mb_s\": %.2f, \"decompress_mb_s\": %.2f, \"compress_ms\": %.3f, \"decompress_ms\": %.3f,\n",
+           size ? (double)compressed / size : 0.0, ok && best_compress > 0 ? mb / best_compress : 0.0,
+           ok && best_decompress > 0 ? mb / best_decompress : 0.0, best_compress * 1e3, best_decompress * 1e3);
+    printf("     \"peak_rss_kib\": %ld, \"roundtrip\": %s, \"stages_ms\": ", usage.ru_maxrss, roundtrip ? "true" : "false");
+    if (staged && ok) {
+        printf("{");
+        for (int s = 0; s < STAGE_COUNT; s++) printf("%s\"%s\": %.3f", s ? ", " : "", bench_stage_names[s], best_stages[s] * 1e3);
+        printf("}");
+    } else {
+        printf("null");
+    }
+#ifdef HUFF_PROFILE
+    printf(",\n     \"profile\": {");
+    int listed = 0;
+    for (int s = 0; s < HUFF_STAGE_COUNT; s++) {
+        if (profile[s].calls == 0) continue;
+        printf("%s\"%s\": {\"calls\": %llu, \"bytes\": %llu, \"wall_ms\": %.3f, \"cpu_ms\": %.3f}", listed++ ? ", " : "",
+               huff_stage_names[s], (unsigned long long)profile[s].calls, (unsigned long long)profile[s].bytes,
+               profile[s].wall_ns / 1e6, profile[s].cpu_ns / 1e6);
+    }
+    printf("}");
+#endif
+    printf("}");
+    fflush(stdout);
+}
+
+// Lê "-m original,lz" em selected[]. Retorna 0 se algum nome não existir
+static int parse_modes(char* list, int selected[MODE_COUNT]) {
+    memset(selected, 0, MODE_COUNT * sizeof(int));
+    for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        int found = 0;
+        for (int m = 0; m < MODE_COUNT; m++) {
+            if (strcmp(name, bench_mode_names[m]) == 0) selected[m] = found = 1;
+        }
+        if (!found) {
+            fprintf(stderr, "Modo desconhecido: %s\n", name);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t large_mib = BENCH_LARGE_MIB;
+    const char* dir = BENCH_DIR;
+    int repetitions = BENCH_REPETITIONS;
+    int selected[MODE_COUNT];
+    for (int m = 0; m < MODE_COUNT; m++) selected[m] = 1;
+
+    for (int i = 1; i < argc; i++) {
+        int has_value = i + 1 < argc;
+        if (strcmp(argv[i], "-s") == 0 && has_value) large_mib = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-d") == 0 && has_value) dir = argv[++i];
+        else if (strcmp(argv[i], "-r") == 0 && has_value) repetitions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && has_value) {
+            if (!parse_modes(argv[++i], selected)) return 1;
+        } else {
+            fprintf(stderr, "Uso: %s [-s MiB do grande] [-d pasta] [-m modo,modo,...] [-r repetições]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (repetitions < 1) repetitions = 1;
+
+    // 1. Corpus
+    mkdir(dir, 0755);
+    make_vocabulary();
+    for (size_t f = 0; f < BENCH_FILE_COUNT; f++) {
+        char path[BENCH_PATH];
+        snprintf(path, sizeof(path), "%s/%s", dir, bench_files[f].name);
+        uint64_t size = bench_files[f].size ? bench_files[f].size : large_mib << 20;
+        if (!generate_file(path, bench_files[f].generator, size)) return 1;
+    }
+
+    // 2. Um processo filho por caso
+    printf("{\"threads\": %ld, \"results\": [\n", sysconf(_SC_NPROCESSORS_ONLN));
+    int first = 1, failures = 0;
+    for (size_t f = 0; f < BENCH_FILE_COUNT; f++) {
+        for (int m = 0; m < MODE_COUNT; m++) {
+            if (!selected[m]) continue;
+            fprintf(stderr, "%s / %s\n", bench_files[f].name, bench_mode_names[m]);
+            printf("%s", first ? "" : ",\n");
+            first = 0;
+            fflush(stdout); //senão o filho herda o buffer e imprime tudo de novo
+
+            pid_t child = fork();
+            if (child == 0) {
+                run_case(dir, bench_files[f].name, (BenchMode)m, repetitions);
+                _exit(0);
+            }
+
+            int status = 0;
+            if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                printf("    {\"file\": \"%s\", \"mode\": \"%s\", \"error\": \"o processo do caso terminou com erro\"}",
+                       bench_files[f].name, bench_mode_names[m]);
+                failures++;
+            }
+        }
+    }
+    printf("\n]}\n");
+    return failures > 0;
+}
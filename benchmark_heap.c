@@ -0,0 +1,148 @@
+/*
+    BENCHMARK: PRIORITY_QUEUE (pqueue_heap.h) × DHEAP (pqueue_dary_heap.h)
+
+    1. Construção da árvore de Huffman com 256 folhas (o uso atual do heap):
+       insere as folhas, depois tira 2 e insere 1 até sobrar a raiz.
+    2. Heap grande (o PRIORITY_QUEUE não passa de 256): monta com dheap_build,
+       faz decrease-key aleatórios (como o VSIDS) e esvazia, com 2, 4 e 8 filhos.
+       Também confere que os elementos saem em ordem.
+
+    Compilar: gcc -O2 benchmark_heap.c -o benchmark_heap -pthread
+    Rodar:    ./benchmark_heap [elementos do heap grande]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "huffman.h"
+#include "pqueue_heap.h"
+#include "pqueue_dary_heap.h"
+
+#define BENCH_TREES 20000
+#define BENCH_LARGE 1000000
+
+double now_seconds() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// Árvore com o PRIORITY_QUEUE de sempre. Retorna a frequência da raiz (para o compilador não sumir com o laço)
+uint64_t tree_with_priority_queue(const uint64_t freq[256], NODE_POOL* pool) {
+    PRIORITY_QUEUE* pq = create_queue();
+    reset_node_pool(pool);
+
+    for (int s = 0; s < 256; s++) insert(pq, create_node(pool, (unsigned char)s, freq[s], NULL, NULL));
+    NODE* root = build_huffman_tree(pq, pool);
+
+    free(pq);
+    return root->frequency;
+}
+
+// Mesma árvore com o DHEAP: ids 0..255 são as folhas, 256..510 os nós internos
+uint64_t tree_with_dheap(DHEAP* h, const uint64_t freq[256], const int ids[256]) {
+    dheap_build(h, ids, freq, 256);
+
+    int next = 256;
+    while (h->size > 1) {
+        int left = dheap_pop(h);
+        int right = dheap_pop(h);
+        dheap_push(h, next, h->key[left] + h->key[right]);
+        next++;
+    }
+    return h->key[dheap_pop(h)];
+}
+
+void bench_large(int n, int arity) {
+    DHEAP* h = dheap_create(n, arity);
+    int* ids = malloc(sizeof(int) * (size_t)n);
+    uint64_t* keys = malloc(sizeof(uint64_t) * (size_t)n);
+    if (!h || !ids || !keys) {
+        fprintf(stderr, "Erro: memória insuficiente\n");
+        exit(1);
+    }
+
+    srand(7);
+    for (int i = 0; i < n; i++) {
+        ids[i] = i;
+        keys[i] = ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+    }
+
+    double start = now_seconds();
+    dheap_build(h, ids, keys, n);
+    double built = now_seconds();
+
+    for (int i = 0; i < n; i++) { //uma diminuição de prioridade por elemento, em ordem aleatória
+        int id = rand() % n;
+        dheap_decrease_key(h, id, h->key[id] / 2);
+    }
+    double decreased = now_seconds();
+
+    uint64_t previous = 0;
+    int sorted = 1;
+    while (!dheap_is_empty(h)) {
+        int id = dheap_pop(h);
+        if (h->key[id] < previous) sorted = 0;
+        previous = h->key[id];
+    }
+    double end = now_seconds();
+
+    printf("  %d filhos: build %7.1f ms | decrease-key %7.1f ms | esvaziar %7.1f ms | em ordem: %s\n", h->arity,
+           (built - start) * 1e3, (decreased - built) * 1e3, (end - decreased) * 1e3, sorted ? "sim" : "NAO");
+
+    free(ids);
+    free(keys);
+    dheap_free(h);
+}
+
+int main(int argc, char* argv[]) {
+    int large = argc > 1 ? atoi(argv[1]) : BENCH_LARGE;
+    if (large <= 0) large = BENCH_LARGE;
+
+    // 1. Árvore de Huffman
+    uint64_t freq[256];
+    int ids[256];
+    srand(42);
+    for (int s = 0; s < 256; s++) {
+        freq[s] = 1 + rand() % 100000;
+        ids[s] = s;
+    }
+
+    NODE_POOL* pool = create_node_pool();
+    DHEAP* h2 = dheap_create(2 * 256 - 1, 2);
+    DHEAP* h4 = dheap_create(2 * 256 - 1, 4);
+    if (!pool || !h2 || !h4) {
+        fprintf(stderr, "Erro: memória insuficiente\n");
+        return 1;
+    }
+
+    uint64_t roots[3] = {0};
+    double elapsed[3];
+    for (int method = 0; method < 3; method++) {
+        double start = now_seconds();
+        for (int r = 0; r < BENCH_TREES; r++) {
+            if (method == 0) roots[0] = tree_with_priority_queue(freq, pool);
+            if (method == 1) roots[1] = tree_with_dheap(h2, freq, ids);
+            if (method == 2) roots[2] = tree_with_dheap(h4, freq, ids);
+        }
+        elapsed[method] = (now_seconds() - start) / BENCH_TREES * 1e9;
+    }
+
+    printf("Arvore de Huffman, 256 folhas (ns por arvore):\n");
+    printf("  PRIORITY_QUEUE: %8.0f\n  DHEAP 2 filhos: %8.0f\n  DHEAP 4 filhos: %8.0f\n", elapsed[0], elapsed[1], elapsed[2]);
+    printf("  mesma raiz: %s\n", roots[0] == roots[1] && roots[1] == roots[2] ? "sim" : "NAO");
+
+    free_node_pool(pool);
+    dheap_free(h2);
+    dheap_free(h4);
+
+    // 2. Heap grande
+    printf("\nHeap com %d elementos:\n", large);
+    bench_large(large, 2);
+    bench_large(large, 4);
+    bench_large(large, 8);
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+    HUFFMAN ADAPTATIVO (algoritmo FGK, uma passada só)
+
+    Os outros modos contam as frequências antes (primeira leitura) e
+    compactam depois (segunda leitura). Aqui compactador e descompactador
+    começam com a mesma árvore vazia e a atualizam do mesmo jeito depois de
+    cada byte: o código de um byte muda conforme o arquivo vai sendo lido.
+    Nada de árvore no cabeçalho e a entrada é lida uma vez só (serve para pipe
+    e para discos de rede, onde ler duas vezes custa o dobro).
+
+    A árvore começa só com a folha NYT ("ainda não visto", peso 0).
+    - Byte já visto: escreve o caminho até a folha dele.
+    - Byte novo: escreve o caminho até NYT e depois o byte em 9 bits. NYT vira
+      um nó interno com dois filhos: um novo NYT e a folha do byte.
+    - Fim do arquivo: o símbolo especial 256, também como "byte novo"
+      (por isso 9 bits e não 8).
+
+    Depois de cada byte, o peso da folha e dos ancestrais aumenta em 1. Para a
+    árvore continuar sendo uma árvore de Huffman, os nós são numerados (raiz
+    = maior número) e mantidos em ordem crescente de peso ("propriedade dos
+    irmãos"). Antes de aumentar o peso de um nó, ele troca de lugar com o nó
+    de maior número que tem o mesmo peso (o "líder" do bloco).
+
+    Exemplo: "aab"
+    início:   NYT
+    'a' novo: NYT + 'a'(9 bits)        árvore: (NYT, a:1)
+    'a':      caminho até a → "1"     árvore: (NYT, a:2)
+    'b' novo: caminho até NYT → "0" + 'b'(9 bits)
+
+    Layout: "HUFA" | versão (1 byte) | 3 bytes zerados | bits (o último byte completado com zeros)
+*/
+
+#ifndef HUFF_ADAPTIVE_H
+#define HUFF_ADAPTIVE_H
+
+#include "huffman.h"
+
+#define HUFF_ADAPTIVE_VERSION 1
+#define HUFF_ADAPTIVE_HEADER_SIZE 8
+#define HUFF_ADAPTIVE_END 256                  //símbolo de fim do arquivo
+#define HUFF_ADAPTIVE_SYMBOL_BITS 9            //bits de um símbolo novo (0..256)
+#define HUFF_ADAPTIVE_NODES (2 * 257 - 1)      //257 folhas + 256 nós internos
+#define HUFF_ADAPTIVE_ROOT (HUFF_ADAPTIVE_NODES - 1)
+
+// Os nós ficam no vetor na posição do seu número: filhos e pai são posições, não ponteiros
+typedef struct {
+    uint64_t weight[HUFF_ADAPTIVE_NODES];
+    int16_t parent[HUFF_ADAPTIVE_NODES];
+    int16_t left[HUFF_ADAPTIVE_NODES];   //-1 = folha
+    int16_t right[HUFF_ADAPTIVE_NODES];
+    int16_t symbol[HUFF_ADAPTIVE_NODES]; //-1 = nó interno ou NYT
+    int16_t leaf[257];                   //posição da folha de cada símbolo (-1 = ainda não visto)
+    int nyt;                             //posição do NYT
+} AdaptiveTree;
+
+void adaptive_tree_init(AdaptiveTree* tree) {
+    memset(tree->weight, 0, sizeof(tree->weight));
+    for (int i = 0; i < HUFF_ADAPTIVE_NODES; i++) {
+        tree->parent[i] = tree->left[i] = tree->right[i] = tree->symbol[i] = -1;
+    }
+    for (int s = 0; s < 257; s++) tree->leaf[s] = -1;
+    tree->nyt = HUFF_ADAPTIVE_ROOT; //a árvore começa só com o NYT, na raiz
+}
+
+// Troca o conteúdo de duas posições (subárvores inteiras); o pai de cada posição continua o mesmo
+void adaptive_swap(AdaptiveTree* tree, int a, int b) {
+    int16_t left = tree->left[a], right = tree->right[a], symbol = tree->symbol[a];
+    tree->left[a] = tree->left[b];
+    tree->right[a] = tree->right[b];
+    tree->symbol[a] = tree->symbol[b];
+    tree->left[b] = left;
+    tree->right[b] = right;
+    tree->symbol[b] = symbol;
+
+    int positions[2] = {a, b};
+    for (int i = 0; i < 2; i++) {
+        int p = positions[i];
+        if (tree->symbol[p] >= 0) tree->leaf[tree->symbol[p]] = (int16_t)p;
+        if (tree->left[p] >= 0) {
+            tree->parent[tree->left[p]] = (int16_t)p;
+            tree->parent[tree->right[p]] = (int16_t)p;
+        }
+    }
+    //os pesos são iguais (só trocamos dentro do mesmo bloco), não precisam mudar
+}
+
+// Conta mais uma ocorrência de symbol e rearruma a árvore
+void adaptive_update(AdaptiveTree* tree, int symbol) {
+    int q = tree->leaf[symbol];
+
+    if (q < 0) {
+        // Byte novo: o NYT ganha dois filhos, o novo NYT (esquerda) e a folha (direita)
+        int old = tree->nyt;
+        int leaf = old - 1;
+        int nyt = old - 2;
+
+        tree->left[old] = (int16_t)nyt;
+        tree->right[old] = (int16_t)leaf;
+        tree->parent[nyt] = tree->parent[leaf] = (int16_t)old;
+        tree->symbol[leaf] = (int16_t)symbol;
+        tree->leaf[symbol] = (int16_t)leaf;
+        tree->nyt = nyt;
+        q = leaf;
+    }
+
+    while (1) {
+        // Líder do bloco: maior posição com o mesmo peso (os pesos crescem com a posição)
+        int leader = q;
+        while (leader < HUFF_ADAPTIVE_ROOT && tree->weight[leader + 1] == tree->weight[q]) leader++;
+
+        if (leader != q && leader != tree->parent[q]) {
+            adaptive_swap(tree, q, leader);
+            q = leader;
+        }
+        tree->weight[q]++;
+
+        if (q == HUFF_ADAPTIVE_ROOT) break;
+        q = tree->parent[q];
+    }
+}
+
+// Escreve o caminho da raiz até a posição node
+void adaptive_write_path(const AdaptiveTree* tree, int node, BitWriter* bits, HuffWriter* out) {
+    uint32_t path[HUFF_ADAPTIVE_NODES / 32 + 1] = {0}; //bits do caminho, da folha para a raiz
+    int length = 0;
+
+    while (node != HUFF_ADAPTIVE_ROOT) {
+        int parent = tree->parent[node];
+        if (tree->right[parent] == node) path[length / 32] |= 1u << (length % 32);
+        length++;
+        node = parent;
+    }
+
+    //o arquivo precisa do caminho da raiz para a folha: lemos os bits ao contrário
+    while (length > 0) {
+        int n = length < 32 ? length : 32;
+        uint32_t code = 0;
+        for (int i = 0; i < n; i++) {
+            length--;
+            code = (code << 1) | ((path[length / 32] >> (length % 32)) & 1);
+        }
+        bit_writer_put(bits, out, code, n);
+    }
+}
+
+void adaptive_encode(AdaptiveTree* tree, int symbol, BitWriter* bits, HuffWriter* out) {
+    if (tree->leaf[symbol] >= 0) {
+        adaptive_write_path(tree, tree->leaf[symbol], bits, out);
+    } else {
+        adaptive_write_path(tree, tree->nyt, bits, out);
+        bit_writer_put(bits, out, (uint32_t)symbol, HUFF_ADAPTIVE_SYMBOL_BITS);
+    }
+}
+
+/*Compacta input lendo cada byte uma única vez (serve para pipe). Retorna 1 se deu certo.*/
+int compress_adaptive(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    AdaptiveTree* tree = malloc(sizeof(AdaptiveTree));
+    if (!tree || !huff_reader_open(&reader, input, 0)) {
+        free(tree);
+        return 0;
+    }
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        free(tree);
+        return 0;
+    }
+
+    huff_write_bytes(&writer, (const unsigned char*)HUFF_ADAPTIVE_MAGIC, 4);
+    huff_write_byte(&writer, HUFF_ADAPTIVE_VERSION);
+    for (int i = 0; i < 3; i++) huff_write_byte(&writer, 0);
+
+    adaptive_tree_init(tree);
+    BitWriter bits = {0, 0};
+
+    while (huff_reader_refill(&reader) > 0) {
+        for (size_t i = 0; i < reader.len; i++) {
+            adaptive_encode(tree, reader.data[i], &bits, &writer);
+            adaptive_update(tree, reader.data[i]);
+        }
+    }
+    adaptive_encode(tree, HUFF_ADAPTIVE_END, &bits, &writer);
+    bit_writer_finish(&bits, &writer);
+
+    int ok = huff_writer_close(&writer);
+    huff_reader_close(&reader);
+    free(tree);
+    return ok;
+}
+
+// Próximo bit do arquivo (do mais significativo para o menos), EOF no fim
+static inline int adaptive_read_bit(HuffReader* reader, int* byte, int* bits_left) {
+    if (*bits_left == 0) {
+        *byte = huff_read_byte(reader);
+        if (*byte == EOF) return EOF;
+        *bits_left = 8;
+    }
+    (*bits_left)--;
+    return (*byte >> *bits_left) & 1;
+}
+
+// Descompacta um arquivo gerado por compress_adaptive(). Retorna 1 se deu certo
+int decompress_adaptive(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    AdaptiveTree* tree = malloc(sizeof(AdaptiveTree));
+    rewind(input);
+    if (!tree || !huff_reader_open(&reader, input, 0)) {
+        free(tree);
+        return 0;
+    }
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        free(tree);
+        return 0;
+    }
+
+    unsigned char header[HUFF_ADAPTIVE_HEADER_SIZE];
+    const unsigned char* data;
+    int ok = huff_reader_take(&reader, sizeof(header), header, &data) == sizeof(header) &&
+             memcmp(data, HUFF_ADAPTIVE_MAGIC, 4) == 0 && data[4] == HUFF_ADAPTIVE_VERSION;
+
+    adaptive_tree_init(tree);
+    int byte = 0, bits_left = 0;
+
+    while (ok) {
+        // 1. Desce da raiz até uma folha ou o NYT
+        int node = HUFF_ADAPTIVE_ROOT;
+        while (ok && tree->left[node] >= 0) {
+            int bit = adaptive_read_bit(&reader, &byte, &bits_left);
+            if (bit == EOF) ok = 0;
+            else node = bit ? tree->right[node] : tree->left[node];
+        }
+        if (!ok) break;
+
+        // 2. NYT: o símbolo vem logo depois, em 9 bits
+        int symbol = tree->symbol[node];
+        if (node == tree->nyt) {
+            symbol = 0;
+            for (int i = 0; i < HUFF_ADAPTIVE_SYMBOL_BITS && ok; i++) {
+                int bit = adaptive_read_bit(&reader, &byte, &bits_left);
+                if (bit == EOF) ok = 0;
+                symbol = (symbol << 1) | bit;
+            }
+            //9 bits vão até 511, mas só existem 0..255 e HUFF_ADAPTIVE_END: fora disso, ou byte "novo" que já existe, é corrompido
+            if (!ok || symbol > HUFF_ADAPTIVE_END || (symbol != HUFF_ADAPTIVE_END && tree->leaf[symbol] >= 0)) {
+                ok = 0;
+                break;
+            }
+        }
+        if (symbol == HUFF_ADAPTIVE_END) break;
+
+        huff_write_byte(&writer, (unsigned char)symbol);
+        adaptive_update(tree, symbol); //mesma atualização do compactador
+    }
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    free(tree);
+    return ok;
+}
+
+#endif // HUFF_ADAPTIVE_H
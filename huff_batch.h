@@ -0,0 +1,385 @@
+/*
+    COMPACTAÇÃO EM LOTE, EM PARALELO (diretórios inteiros)
+
+    O modo em lote de huff_ctx.h compacta uma lista de arquivos em um núcleo.
+    Aqui a lista (arquivos e diretórios, percorridos recursivamente) vira uma
+    lista de TAREFAS para o pool de threads (huff_pool.h):
+
+    - arquivo pequeno (até chunk_size bytes): uma tarefa, formato canônico,
+      usando um huff_ctx emprestado (cada thread reaproveita os buffers de um
+      contexto; ver huff_batch_take_ctx);
+    - arquivo grande: uma tarefa por pedaço, formato em pedaços (huff_chunked.h).
+      Os pedaços ficam em memória; a thread que termina o ÚLTIMO pedaço de um
+      arquivo escreve o .huff dele. Vários arquivos são escritos ao mesmo tempo,
+      cada um por uma thread diferente.
+
+    BALANCEAMENTO
+
+    O pool entrega a próxima tarefa livre para a primeira thread que ficar
+    desocupada (não há divisão fixa por thread), então uma thread presa num
+    arquivo lento não segura as outras. Para os tamanhos muito desiguais
+    (um arquivo de 2 GB no meio de 50 mil de 4 KB):
+    - nenhuma tarefa passa de chunk_size bytes: o arquivo de 2 GB vira 2048
+      tarefas de 1 MiB, espalhadas por todas as threads;
+    - as tarefas são ordenadas da maior para a menor (pedaços primeiro): o
+      que sobra para o final são só arquivos pequenos, e as threads terminam
+      quase juntas.
+
+    Exemplo, 4 threads: [A: 3 pedaços][B: 1 pedaço][c, d, e, f pequenos]
+    tarefas: A0 A1 A2 B0 c d e f → thread 1: A0 c f | thread 2: A1 d | ...
+
+    Cada arquivo de entrada X gera X.huff ao lado dele. Arquivos que já
+    terminam em .huff são pulados ao percorrer diretórios.
+*/
+
+#ifndef HUFF_BATCH_H
+#define HUFF_BATCH_H
+
+#include <time.h>
+#include <pthread.h>
+#include "huffman.h"
+#include "huff_pool.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+typedef struct {
+    char* path;
+    char* output_path;
+    uint64_t size;
+    size_t chunk_count;       //0 = arquivo pequeno (uma tarefa só)
+    HuffChunk* chunks;        //arquivo grande: pedaços compactados, esperando o último
+    HuffReader reader;        //arquivo grande mapeado (ou lido inteiro em buffer)
+    unsigned char* buffer;    //arquivo grande sem mmap: o arquivo inteiro
+    size_t remaining;         //pedaços ainda não terminados (protegido por HuffBatch.lock)
+    int failed;
+} HuffBatchFile;
+
+typedef struct {
+    uint32_t file;
+    uint32_t chunk;
+    uint64_t size;            //bytes de entrada da tarefa (para ordenar)
+} HuffBatchTask;
+
+typedef struct {
+    size_t files;
+    size_t failures;
+    uint64_t input_bytes;
+    uint64_t output_bytes;
+    double seconds;
+    int threads;
+} HuffBatchStats;
+
+typedef struct {
+    HuffBatchFile* files;
+    size_t file_count, file_capacity;
+    HuffBatchTask* tasks;
+    size_t chunk_size;
+
+    pthread_mutex_t lock;     //protege remaining, os contextos livres e stats
+    huff_ctx** free_ctx;      //contextos devolvidos pelas tarefas (no máximo um por thread)
+    size_t free_ctx_count;
+    HuffBatchStats stats;
+} HuffBatch;
+
+static int huff_batch_add_file(HuffBatch* batch, const char* path, uint64_t size) {
+    if (batch->file_count == batch->file_capacity) {
+        size_t capacity = batch->file_capacity ? batch->file_capacity * 2 : 256;
+        HuffBatchFile* bigger = realloc(batch->files, capacity * sizeof(HuffBatchFile));
+        if (!bigger) return 0;
+        batch->files = bigger;
+        batch->file_capacity = capacity;
+    }
+
+    HuffBatchFile* file = &batch->files[batch->file_count];
+    memset(file, 0, sizeof(HuffBatchFile));
+    file->path = malloc(strlen(path) + 1);
+    file->output_path = malloc(strlen(path) + 6);
+    if (!file->path || !file->output_path) {
+        free(file->path);
+        free(file->output_path);
+        return 0;
+    }
+    strcpy(file->path, path);
+    sprintf(file->output_path, "%s.huff", path);
+    file->size = size;
+    batch->file_count++;
+    return 1;
+}
+
+static int huff_batch_is_huff(const char* name) {
+    size_t length = strlen(name);
+    return length > 5 && strcmp(name + length - 5, ".huff") == 0;
+}
+
+// Arquivo → uma entrada; diretório → todos os arquivos dentro dele (links simbólicos são ignorados)
+static int huff_batch_collect(HuffBatch* batch, const char* path, int from_directory) {
+#ifndef _WIN32
+    struct stat st;
+    if (lstat(path, &st) != 0) {
+        perror(path);
+        return 0;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path);
+        if (!dir) {
+            perror(path);
+            return 0;
+        }
+        int ok = 1;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+            size_t length = strlen(path) + strlen(entry->d_name) + 2;
+            char* child = malloc(length);
+            if (!child) {
+                ok = 0;
+                break;
+            }
+            snprintf(child, length, "%s/%s", path, entry->d_name);
+            if (!huff_batch_collect(batch, child, 1)) ok = 0;
+            free(child);
+        }
+        closedir(dir);
+        return ok;
+    }
+
+    if (!S_ISREG(st.st_mode)) return 1;                    //links, dispositivos, pipes
+    if (from_directory && huff_batch_is_huff(path)) return 1; //saída de uma rodada anterior
+    return huff_batch_add_file(batch, path, (uint64_t)st.st_size);
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return 0;
+    }
+    uint64_t size;
+    int ok = huff_file_size(file, &size);
+    fclose(file);
+    return ok && huff_batch_add_file(batch, path, size);
+#endif
+}
+
+// Maior primeiro; empate: mesma ordem dos arquivos e dos pedaços
+static int huff_batch_compare_tasks(const void* a, const void* b) {
+    const HuffBatchTask* x = a;
+    const HuffBatchTask* y = b;
+    if (x->size != y->size) return x->size > y->size ? -1 : 1;
+    if (x->file != y->file) return x->file < y->file ? -1 : 1;
+    return x->chunk < y->chunk ? -1 : (x->chunk > y->chunk);
+}
+
+/*Arquivo grande: mapeia (ou lê inteiro) e aponta cada pedaço para o seu trecho.
+Roda antes do pool, na thread principal: o mmap não lê nada do disco ainda.*/
+static int huff_batch_prepare_chunks(HuffBatch* batch, HuffBatchFile* file) {
+    FILE* input = fopen(file->path, "rb");
+    if (!input) {
+        perror(file->path);
+        return 0;
+    }
+
+    const unsigned char* data = NULL;
+    int ok = huff_reader_open_mapped(&file->reader, input);
+    if (ok && file->reader.map) {
+        data = file->reader.map;
+        file->size = file->reader.map_size; //o arquivo pode ter mudado desde o stat
+    } else if (ok) {
+        huff_reader_close(&file->reader);
+        file->buffer = malloc(file->size ? file->size : 1);
+        ok = file->buffer && fread(file->buffer, 1, file->size, input) == file->size;
+        data = file->buffer;
+    }
+    fclose(input); //o mapeamento continua valendo depois do fclose
+    if (!ok) return 0;
+
+    file->chunk_count = (file->size + batch->chunk_size - 1) / batch->chunk_size;
+    file->chunks = calloc(file->chunk_count, sizeof(HuffChunk));
+    if (!file->chunks) return 0;
+
+    for (size_t i = 0; i < file->chunk_count; i++) {
+        uint64_t start = (uint64_t)i * batch->chunk_size;
+        file->chunks[i].input = data + start;
+        file->chunks[i].input_size = file->size - start < batch->chunk_size ? file->size - start : batch->chunk_size;
+    }
+    file->remaining = file->chunk_count;
+    return 1;
+}
+
+// Empresta um contexto livre (ou cria um). Nunca há mais contextos que threads
+static huff_ctx* huff_batch_take_ctx(HuffBatch* batch) {
+    huff_ctx* ctx = NULL;
+    pthread_mutex_lock(&batch->lock);
+    if (batch->free_ctx_count > 0) ctx = batch->free_ctx[--batch->free_ctx_count];
+    pthread_mutex_unlock(&batch->lock);
+    return ctx ? ctx : huff_ctx_create();
+}
+
+static void huff_batch_give_ctx(HuffBatch* batch, huff_ctx* ctx) {
+    pthread_mutex_lock(&batch->lock);
+    batch->free_ctx[batch->free_ctx_count++] = ctx;
+    pthread_mutex_unlock(&batch->lock);
+}
+
+static void huff_batch_finish_file(HuffBatch* batch, HuffBatchFile* file, uint64_t output_size) {
+    pthread_mutex_lock(&batch->lock);
+    if (file->failed) {
+        batch->stats.failures++;
+        fprintf(stderr, "Erro ao compactar %s\n", file->path);
+    } else {
+        batch->stats.input_bytes += file->size;
+        batch->stats.output_bytes += output_size;
+    }
+    pthread_mutex_unlock(&batch->lock);
+}
+
+// Todos os pedaços prontos: escreve o .huff em pedaços e libera a memória do arquivo
+static void huff_batch_write_chunked(HuffBatch* batch, HuffBatchFile* file) {
+    uint64_t* offsets = malloc(file->chunk_count * sizeof(uint64_t));
+    FILE* output = NULL;
+    HuffWriter writer;
+    uint64_t position = HUFF_CHUNKED_HEADER_SIZE;
+
+    for (size_t i = 0; i < file->chunk_count; i++) {
+        if (file->chunks[i].failed) file->failed = 1;
+    }
+    if (!offsets || file->failed || !(output = fopen(file->output_path, "wb")) || !huff_writer_open(&writer, output, 0)) {
+        if (!file->failed) perror(file->output_path);
+        file->failed = 1;
+    } else {
+        write_chunked_header(&writer, batch->chunk_size);
+        for (size_t i = 0; i < file->chunk_count; i++) {
+            offsets[i] = position;
+            position += write_chunk_record(&writer, &file->chunks[i]);
+        }
+        write_chunked_footer(&writer, offsets, file->chunk_count, position, file->size);
+        if (!huff_writer_close(&writer)) file->failed = 1;
+        position += file->chunk_count * 8 + HUFF_CHUNKED_FOOTER_SIZE;
+    }
+    if (output && fclose(output) != 0) file->failed = 1;
+
+    for (size_t i = 0; i < file->chunk_count; i++) huff_writer_close(&file->chunks[i].output);
+    free(file->chunks);
+    file->chunks = NULL;
+    huff_reader_close(&file->reader);
+    free(file->buffer);
+    file->buffer = NULL;
+    free(offsets);
+
+    huff_batch_finish_file(batch, file, position);
+}
+
+static void huff_batch_task(void* ctx, size_t index) {
+    HuffBatch* batch = ctx;
+    HuffBatchTask* task = &batch->tasks[index];
+    HuffBatchFile* file = &batch->files[task->file];
+
+    if (file->chunk_count == 0) { // arquivo pequeno: formato canônico com um contexto emprestado
+        huff_ctx* hctx = huff_batch_take_ctx(batch);
+        uint64_t output_size = 0;
+        if (hctx && huff_ctx_compress_file(hctx, file->path, file->output_path)) {
+            output_size = hctx->output.pos;
+        } else {
+            file->failed = 1;
+        }
+        if (hctx) huff_batch_give_ctx(batch, hctx);
+        huff_batch_finish_file(batch, file, output_size);
+        return;
+    }
+
+    compress_chunk_task(file->chunks, task->chunk);
+
+    pthread_mutex_lock(&batch->lock);
+    int last = --file->remaining == 0;
+    pthread_mutex_unlock(&batch->lock);
+    if (last) huff_batch_write_chunked(batch, file); //só uma thread chega aqui por arquivo
+}
+
+/*Compacta cada arquivo de paths (diretórios são percorridos) para arquivo.huff,
+com threads (<= 0 = todos os núcleos) e pedaços de chunk_size (0 = HUFF_CHUNK_SIZE).
+Preenche stats (pode ser NULL). Retorna 1 se todos os arquivos deram certo.*/
+int compress_batch(char* const paths[], size_t path_count, size_t chunk_size, int threads, HuffBatchStats* stats) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    HuffBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.chunk_size = chunk_size ? chunk_size : HUFF_CHUNK_SIZE;
+    if (batch.chunk_size > UINT32_MAX) batch.chunk_size = UINT32_MAX;
+    pthread_mutex_init(&batch.lock, NULL);
+
+    // 1. Lista de arquivos
+    int ok = 1;
+    for (size_t i = 0; i < path_count; i++) {
+        if (!huff_batch_collect(&batch, paths[i], 0)) ok = 0;
+    }
+
+    // 2. Lista de tarefas: um pedaço por tarefa nos arquivos grandes
+    size_t task_count = 0;
+    for (size_t f = 0; f < batch.file_count; f++) {
+        HuffBatchFile* file = &batch.files[f];
+        if (file->size > batch.chunk_size && !huff_batch_prepare_chunks(&batch, file)) {
+            fprintf(stderr, "Erro ao abrir %s\n", file->path);
+            file->failed = 1;
+            batch.stats.failures++;
+            continue;
+        }
+        task_count += file->chunk_count ? file->chunk_count : 1;
+    }
+
+    HuffPool* pool = huff_pool_create(threads);
+    batch.tasks = malloc((task_count ? task_count : 1) * sizeof(HuffBatchTask));
+    batch.free_ctx = pool ? malloc(sizeof(huff_ctx*) * (size_t)pool->thread_count) : NULL;
+
+    if (pool && batch.tasks && batch.free_ctx) {
+        size_t t = 0;
+        for (size_t f = 0; f < batch.file_count; f++) {
+            HuffBatchFile* file = &batch.files[f];
+            if (file->failed) continue;
+            if (file->chunk_count == 0) {
+                batch.tasks[t++] = (HuffBatchTask){(uint32_t)f, 0, file->size};
+            }
+            for (size_t c = 0; c < file->chunk_count; c++) {
+                batch.tasks[t++] = (HuffBatchTask){(uint32_t)f, (uint32_t)c, file->chunks[c].input_size};
+            }
+        }
+        qsort(batch.tasks, task_count, sizeof(HuffBatchTask), huff_batch_compare_tasks);
+
+        // 3. Tudo em paralelo
+        batch.stats.threads = pool->thread_count;
+        huff_pool_run(pool, task_count, huff_batch_task, &batch);
+    } else {
+        perror("Erro ao preparar o lote");
+        ok = 0;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    batch.stats.files = batch.file_count;
+    batch.stats.seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (batch.stats.failures > 0) ok = 0;
+    if (stats) *stats = batch.stats;
+
+    for (size_t i = 0; i < batch.free_ctx_count; i++) huff_ctx_free(batch.free_ctx[i]);
+    for (size_t f = 0; f < batch.file_count; f++) {
+        HuffBatchFile* file = &batch.files[f];
+        if (file->chunks) { //só sobra se o arquivo não chegou a ser escrito (erro antes do pool)
+            for (size_t i = 0; i < file->chunk_count; i++) huff_writer_close(&file->chunks[i].output);
+            free(file->chunks);
+        }
+        huff_reader_close(&file->reader);
+        free(file->buffer);
+        free(file->path);
+        free(file->output_path);
+    }
+    free(batch.free_ctx);
+    free(batch.tasks);
+    free(batch.files);
+    huff_pool_destroy(pool);
+    pthread_mutex_destroy(&batch.lock);
+    return ok;
+}
+
+#endif // HUFF_BATCH_H
@@ -0,0 +1,86 @@
+/*
+    COMPACTAR DE MEMÓRIA PARA MEMÓRIA (sem arquivos)
+
+    Todas as outras entradas recebem FILE* (e decompact() ainda monta o nome
+    do arquivo de saída). Quem já tem os dados na memória (o corpo de uma
+    requisição, por exemplo) usa estas três funções, que não abrem arquivo
+    nenhum e escrevem direto no buffer de quem chama:
+
+    size_t cap = huff_compress_bound(n);
+    unsigned char* dst = malloc(cap);               // ou um buffer reaproveitado
+    size_t packed = huff_compress(src, n, dst, cap); // 0 = não coube / erro
+    ...
+    size_t size = huff_decompress(dst, packed, out, out_cap);
+
+    O formato é o mesmo de huff_ctx.h: canônico (huff_canonical.h) ou guardado
+    (huff_stored.h) quando não encolhe. Os núcleos também são os mesmos
+    (huff_canonical_encode / huff_canonical_decode / huff_stored_*), só que o
+    HuffWriter aponta para o buffer de quem chama (huff_writer_open_fixed):
+    nada é alocado. A tabela de decodificação (~21 KiB) fica na pilha.
+    A única exceção é o package-merge, quando algum código passaria de
+    HUFF_MAX_CODE_LENGTH bits (ver huff_length_limit.h).
+
+    Como o compactador escolhe o guardado sempre que o canônico não sai menor,
+    o resultado nunca passa de n + HUFF_STORED_HEADER_SIZE bytes.
+*/
+
+#ifndef HUFF_BUFFER_H
+#define HUFF_BUFFER_H
+
+#include "huffman.h"
+
+// Maior tamanho que huff_compress() pode gerar para n bytes: com dst desse tamanho, sempre cabe
+size_t huff_compress_bound(size_t n) {
+    return n + HUFF_STORED_HEADER_SIZE;
+}
+
+/*Compacta os n bytes de src em dst (cap bytes). Retorna quantos bytes foram
+escritos em dst, ou 0 se não couber (cap < huff_compress_bound(n) pode não bastar)
+ou se der erro.*/
+size_t huff_compress(const unsigned char* src, size_t n, unsigned char* dst, size_t cap) {
+    if (cap < HUFF_STORED_HEADER_SIZE) return 0; //nenhum resultado é menor que o cabeçalho guardado
+
+    HuffWriter out;
+    huff_writer_open_fixed(&out, dst, cap);
+    if (!huff_canonical_encode(src, n, &out) || out.error) return 0;
+    return out.pos;
+}
+
+/*Lê de src (n bytes) só o tamanho original gravado no cabeçalho, sem descompactar:
+para quem quer alocar o destino exato antes de chamar huff_decompress().
+Retorna 0 se src não for um resultado de huff_compress().*/
+int huff_decompressed_size(const unsigned char* src, size_t n, uint64_t* size) {
+    if (n < HUFF_STORED_HEADER_SIZE) return 0;
+    if (memcmp(src, HUFF_STORED_MAGIC, 4) != 0 && memcmp(src, HUFF_CANONICAL_MAGIC, 4) != 0) return 0;
+    *size = huff_get_u64(src + 5); //os dois formatos guardam o tamanho no mesmo lugar
+    return 1;
+}
+
+/*Descompacta os n bytes de src (gerados por huff_compress() ou huff_ctx_compress())
+em dst (cap bytes). Retorna o tamanho original, ou 0 se src estiver corrompido ou
+se o original não couber em cap (nada é escrito nesse caso). Um original vazio
+também retorna 0: use huff_decompressed_size() para diferenciar.*/
+size_t huff_decompress(const unsigned char* src, size_t n, unsigned char* dst, size_t cap) {
+    uint64_t original_size;
+    if (!huff_decompressed_size(src, n, &original_size) || original_size > cap) return 0;
+
+    HuffWriter out;
+    huff_writer_open_fixed(&out, dst, cap);
+
+    if (memcmp(src, HUFF_STORED_MAGIC, 4) == 0) {
+        if (!huff_stored_decode(src, n, &out)) return 0;
+        return out.pos;
+    }
+
+    //cada bit gera no máximo um byte: um tamanho maior que isso só pode ser cabeçalho corrompido
+    if (original_size > (uint64_t)n * 8) return 0;
+
+    HuffDecodeTable table;
+    HuffReader reader;
+    huff_reader_open_memory(&reader, src, n);
+    int ok = huff_canonical_decode(&reader, &out, &table, NULL) && !out.error;
+    huff_reader_close(&reader);
+    return ok ? out.pos : 0;
+}
+
+#endif // HUFF_BUFFER_H
@@ -0,0 +1,183 @@
+/*
+    FORMATO CANÔNICO (um fluxo só, sem árvore no arquivo)
+
+    Igual ao .huff original (um cabeçalho + um fluxo de bits contínuo), mas o
+    cabeçalho guarda só os comprimentos dos códigos (write_code_lengths) e os
+    dois lados montam os mesmos códigos canônicos (build_canonical_codes).
+    O descompactador monta a tabela de decodificação direto dos comprimentos:
+    nenhum nó de árvore é alocado.
+
+    Layout do arquivo (inteiros em little-endian, ver huff_write_u32):
+
+    [4 bytes]  "HUFK"
+    [1 byte]   versão
+    [8 bytes]  tamanho original (u64)
+    [...]      comprimentos dos códigos (até 193 bytes, ver write_code_lengths)
+    [...]      bits (huff_encode_block), o último byte completado com zeros
+
+    Não há campo de lixo nem limite de 13 bits: o decodificador para quando
+    escreve o tamanho original.
+
+    Se os bits não ficarem menores que o original, o arquivo sai no formato
+    guardado (huff_stored.h) em vez deste.
+*/
+
+#ifndef HUFF_CANONICAL_H
+#define HUFF_CANONICAL_H
+
+#include "huffman.h"
+#include "huff_pool.h"
+
+#define HUFF_CANONICAL_VERSION 1
+#define HUFF_CANONICAL_HEADER_SIZE 13 //magic + versão + tamanho original
+
+// Cabeçalho: magic, versão, tamanho original e os comprimentos dos códigos
+void write_canonical_header(HuffWriter* writer, uint64_t original_size, const unsigned char lengths[256]) {
+    huff_write_bytes(writer, (const unsigned char*)HUFF_CANONICAL_MAGIC, 4);
+    huff_write_byte(writer, HUFF_CANONICAL_VERSION);
+    huff_write_u64(writer, original_size);
+    write_code_lengths(writer, lengths);
+}
+
+// 1 se o formato guardado sai menor que o canônico com esses comprimentos
+static int canonical_should_store(const uint64_t freq[256], const unsigned char lengths[256], uint64_t original_size) {
+    return huff_store_is_smaller(huff_block_cost(freq, lengths), HUFF_CANONICAL_HEADER_SIZE + code_lengths_size(lengths),
+                                 original_size + HUFF_STORED_HEADER_SIZE);
+}
+
+/*Compacta os n bytes de data (já na memória) no formato canônico (ou guardado, se não encolher), em out.
+Uma passada para as frequências e outra para os bits, sem alocar nada
+(a não ser o package-merge, quando algum código passaria de HUFF_MAX_CODE_LENGTH bits).
+Retorna 1 se deu certo.*/
+int huff_canonical_encode(const unsigned char* data, size_t n, HuffWriter* out) {
+    uint64_t freq[256] = {0};
+    count_frequencies(data, n, freq);
+
+    HuffmanCode huff_table[256];
+    unsigned char lengths[256];
+    if (!huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths) || !build_canonical_codes(lengths, huff_table)) {
+        perror("Erro ao montar os códigos");
+        return 0;
+    }
+    if (canonical_should_store(freq, lengths, n)) return huff_stored_encode(data, n, out);
+
+    write_canonical_header(out, n, lengths);
+    BitWriter bits = {0, 0};
+    huff_encode_block(data, n, huff_table, &bits, out);
+    bit_writer_finish(&bits, out);
+    return !out->error;
+}
+
+/*Lê o cabeçalho e os bits de um arquivo canônico a partir de reader e escreve o
+original em out. table é só espaço de trabalho (quem chama pode reaproveitar).
+original_size, se não for NULL, recebe o tamanho lido do cabeçalho. Retorna 1 se deu certo.*/
+int huff_canonical_decode(HuffReader* reader, HuffWriter* out, HuffDecodeTable* table, uint64_t* original_size) {
+    // 1. Cabeçalho
+    unsigned char scratch[HUFF_CANONICAL_HEADER_SIZE];
+    const unsigned char* header;
+    if (huff_reader_take(reader, HUFF_CANONICAL_HEADER_SIZE, scratch, &header) != HUFF_CANONICAL_HEADER_SIZE ||
+            memcmp(header, HUFF_CANONICAL_MAGIC, 4) != 0 || header[4] != HUFF_CANONICAL_VERSION) {
+        return 0;
+    }
+    uint64_t size = huff_get_u64(header + 5);
+    if (original_size) *original_size = size;
+
+    // 2. Comprimentos → tabela de decodificação (sem árvore)
+    unsigned char lengths[256];
+    if (!read_code_lengths(reader, lengths) || !build_decode_table_from_lengths(lengths, table)) return 0;
+
+    // 3. Bits, até escrever size bytes
+    return huff_decode_stream(reader, out, table, INT64_MAX, size) == size;
+}
+
+/*Compacta input inteiro no formato canônico. Lê o arquivo duas vezes (frequências
+e depois os códigos), então input precisa aceitar rewind. Retorna 1 se deu certo.*/
+int compress_canonical(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    // 1. Frequências (arquivos grandes mapeados são contados por todas as threads)
+    uint64_t freq[256] = {0};
+    uint64_t original_size = 0;
+    HuffPool* pool = NULL;
+    if (reader.map && reader.map_size >= HUFF_HIST_PARALLEL_MIN) pool = huff_pool_create(0);
+
+    size_t got;
+    while ((got = huff_reader_refill(&reader)) > 0) {
+        count_frequencies_parallel(reader.data, got, freq, pool);
+        original_size += got;
+    }
+    huff_pool_destroy(pool);
+
+    // 2. Comprimentos de até HUFF_MAX_CODE_LENGTH bits (duas filas, sem árvore de ponteiros) → códigos canônicos
+    HuffmanCode huff_table[256];
+    unsigned char lengths[256];
+    if (!huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths) || !build_canonical_codes(lengths, huff_table)) {
+        perror("Erro ao montar os códigos");
+        huff_reader_close(&reader);
+        return 0;
+    }
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    // 3. Não encolhe (JPEG, zip...): guarda como está
+    int ok = 1;
+    if (canonical_should_store(freq, lengths, original_size)) {
+        ok = write_stored(&reader, &writer, original_size);
+    } else {
+        // 4. Cabeçalho
+        write_canonical_header(&writer, original_size, lengths);
+
+        // 5. Bits
+        BitWriter bits = {0, 0};
+        huff_reader_rewind(&reader);
+        while ((got = huff_reader_refill(&reader)) > 0) {
+            huff_encode_block(reader.data, got, huff_table, &bits, &writer);
+        }
+        bit_writer_finish(&bits, &writer);
+    }
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    return ok;
+}
+
+// Descompacta um arquivo gerado por compress_canonical(). Retorna 1 se deu certo
+int decompress_canonical(FILE* input, FILE* output) {
+    // O tamanho original vem antes de tudo: a saída é reservada e mapeada já com ele (ver huff_io.h)
+    unsigned char header[HUFF_CANONICAL_HEADER_SIZE];
+    rewind(input);
+    if (fread(header, 1, sizeof(header), input) != sizeof(header)) return 0;
+    if (memcmp(header, HUFF_CANONICAL_MAGIC, 4) != 0 || header[4] != HUFF_CANONICAL_VERSION) return 0;
+    uint64_t original_size = huff_get_u64(header + 5);
+
+    //cada byte gasta pelo menos um bit: um tamanho maior que isso só pode ser cabeçalho corrompido.
+    //Sem o tamanho do arquivo (pipe) não dá para conferir, e a saída não é reservada.
+    uint64_t file_size;
+    int known = huff_file_size(input, &file_size);
+    if (known && original_size > (file_size - HUFF_CANONICAL_HEADER_SIZE) * 8) return 0;
+
+    HuffReader reader;
+    HuffWriter writer;
+    rewind(input);
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    HuffDecodeTable* table = malloc(sizeof(HuffDecodeTable));
+    int opened = table && (known ? huff_writer_open_sized(&writer, output, original_size) : huff_writer_open(&writer, output, 0));
+    if (!opened) {
+        free(table);
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    int ok = huff_canonical_decode(&reader, &writer, table, NULL);
+    if (!huff_writer_close(&writer)) ok = 0;
+    free(table);
+    huff_reader_close(&reader);
+    return ok;
+}
+
+#endif // HUFF_CANONICAL_H
@@ -0,0 +1,607 @@
+/*
+    FORMATO EM PEDAÇOS (vários núcleos)
+
+    O .huff original é um cabeçalho + UM fluxo de bits contínuo: só dá para
+    compactar e descompactar do começo ao fim, em um núcleo. Aqui a entrada é
+    cortada em pedaços independentes (1 MiB por padrão). Cada pedaço tem a sua
+    própria árvore, então os pedaços são compactados em paralelo pelo pool de
+    threads (huff_pool.h) e descompactados em paralelo também.
+
+    Layout do arquivo (inteiros em little-endian, ver huff_write_u32):
+
+    [16 bytes: cabeçalho]  "HUFC" | versão (1 byte) | flags (1 byte) | 2 bytes zerados
+                           | tamanho do pedaço (u32) | 4 bytes zerados
+    [pedaço 0]             tamanho original (u32) | tamanho compactado (u32) | modo (1 byte)
+                           | comprimentos (write_code_lengths) | bits (huff_encode_block)
+    [pedaço 1] ...
+    [índice]               posição de cada pedaço no arquivo (u64 cada)
+    [24 bytes: rodapé]     posição do índice (u64) | tamanho original total (u64)
+                           | quantidade de pedaços (u32) | "HUFI"
+
+    O índice no final deixa o arquivo "pulável": para chegar no pedaço k basta
+    ler o rodapé, o índice e dar fseek. Não há bits de lixo: o decodificador
+    para quando escreve o tamanho original do pedaço.
+
+    O modo de cada pedaço diz como ele foi guardado. Arquivos antigos usavam
+    a árvore em pré-ordem (HUFF_CHUNK_TREE) e continuam sendo lidos.
+
+    FLUXOS INTERCALADOS (HUFF_CHUNK_INTERLEAVED)
+
+    Num fluxo só, cada código depende do anterior: só se sabe onde o código
+    n+1 começa depois de decodificar o código n (consulta na tabela → tamanho
+    → shift → próxima consulta). O processador fica esperando essa corrente,
+    mesmo tendo unidades livres.
+
+    No modo intercalado o pedaço é dividido em 4 quartos e cada quarto vira
+    um fluxo de bits independente (mesma tabela). O decodificador anda nos 4
+    fluxos no mesmo laço: as 4 correntes não dependem umas das outras e o
+    processador executa as consultas ao mesmo tempo.
+
+    [...]      comprimentos (write_code_lengths)
+    [12 bytes] tabela de saltos: tamanho em bytes dos fluxos 0, 1 e 2 (u32 cada)
+    [...]      fluxo 0 | fluxo 1 | fluxo 2 | fluxo 3 (o último vai até o fim do pedaço)
+
+    O quarto k tem os bytes [k × q, (k + 1) × q) do pedaço, q = (tamanho + 3) / 4.
+
+    Pedaços que não encolheriam (trechos de JPEG, zip...) são guardados como
+    estão (HUFF_CHUNK_STORED, ver huff_stored.h): o payload é o próprio
+    pedaço e a descompactação só copia.
+*/
+
+#ifndef HUFF_CHUNKED_H
+#define HUFF_CHUNKED_H
+
+#include "huffman.h"
+#include "huff_pool.h"
+
+#define HUFF_CHUNKED_INDEX_MAGIC "HUFI"
+#define HUFF_CHUNKED_VERSION 1
+#define HUFF_CHUNKED_HEADER_SIZE 16
+#define HUFF_CHUNKED_RECORD_SIZE 9  //u32 original + u32 compactado + 1 byte de modo
+#define HUFF_CHUNKED_FOOTER_SIZE 24
+
+#ifndef HUFF_CHUNK_SIZE
+#define HUFF_CHUNK_SIZE (1024 * 1024) //pedaços de 1 MiB: grandes o bastante para o cabeçalho de cada um não pesar
+#endif
+
+#define HUFF_CHUNK_BATCH_PER_THREAD 4 //pedaços em memória por thread (limita a memória usada)
+
+// Modos de um pedaço (o byte de modo no começo de cada pedaço)
+enum {
+    HUFF_CHUNK_TREE = 0,     //árvore em pré-ordem + bits, igual ao formato original
+    HUFF_CHUNK_CANONICAL = 1, //comprimentos + bits com códigos canônicos
+    HUFF_CHUNK_INTERLEAVED = 2, //comprimentos + tabela de saltos + 4 fluxos (ver acima)
+    HUFF_CHUNK_STORED = 3       //bytes originais, sem compactar
+};
+
+#define HUFF_INTERLEAVED_STREAMS 4
+#define HUFF_INTERLEAVED_JUMP_SIZE 12 //tamanhos dos 3 primeiros fluxos
+#define HUFF_INTERLEAVED_FAST_MAX_LENGTH 19 //3 códigos por leitura de 57 bits (ver huff_decode_interleaved)
+
+//Pedaços intercalados limitam os códigos a 19 bits mesmo com HUFF_MAX_CODE_LENGTH maior: assim sempre usam o caminho rápido
+#if HUFF_MAX_CODE_LENGTH < HUFF_INTERLEAVED_FAST_MAX_LENGTH
+#define HUFF_INTERLEAVED_MAX_LENGTH HUFF_MAX_CODE_LENGTH
+#else
+#define HUFF_INTERLEAVED_MAX_LENGTH HUFF_INTERLEAVED_FAST_MAX_LENGTH
+#endif
+
+typedef struct {
+    const unsigned char* input; //bytes originais do pedaço
+    size_t input_size;
+    const unsigned char* packed_input; //descompactação: payload compactado do pedaço
+    size_t packed_size;
+    unsigned char mode;
+    HuffWriter output;          //resultado (compactado ou descompactado), sempre em memória
+    unsigned char* destination; //descompactação com saída mapeada: onde o pedaço fica no arquivo (NULL = bloco próprio)
+    int failed;
+} HuffChunk;
+
+// Início e fim do quarto k de um pedaço de n bytes
+static void interleaved_quarter(size_t n, int k, size_t* start, size_t* end) {
+    size_t quarter = (n + HUFF_INTERLEAVED_STREAMS - 1) / HUFF_INTERLEAVED_STREAMS;
+    *start = (size_t)k * quarter < n ? (size_t)k * quarter : n;
+    *end = *start + quarter < n ? *start + quarter : n;
+}
+
+// Tabela de saltos + 4 fluxos. out precisa ser um HuffWriter em memória (a tabela é preenchida no fim)
+static void encode_interleaved(const unsigned char* data, size_t n, const HuffmanCode huff_table[256], HuffWriter* out) {
+    size_t jump = out->pos;
+    for (int k = 0; k < HUFF_INTERLEAVED_STREAMS - 1; k++) huff_write_u32(out, 0);
+
+    for (int k = 0; k < HUFF_INTERLEAVED_STREAMS; k++) {
+        size_t start, end;
+        interleaved_quarter(n, k, &start, &end);
+
+        size_t begin = out->pos;
+        BitWriter bits = {0, 0};
+        huff_encode_block(data + start, end - start, huff_table, &bits, out);
+        bit_writer_finish(&bits, out);
+
+        if (k < HUFF_INTERLEAVED_STREAMS - 1 && !out->error) huff_set_u32(out->data + jump + 4 * k, (uint32_t)(out->pos - begin));
+    }
+}
+
+// Um fluxo de bits na memória; bit_pos conta a partir do bit mais significativo de data[0]
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    uint64_t bit_pos;
+} HuffBitStream;
+
+// Próximos 64 bits do fluxo, alinhados à esquerda. Só vale se houver 8 bytes a partir da posição atual
+static inline uint64_t bitstream_peek_fast(const HuffBitStream* s) {
+    const unsigned char* p = s->data + (s->bit_pos >> 3);
+    uint64_t v = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+                 ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+    return v << (s->bit_pos & 7); //sobram pelo menos 57 bits válidos
+}
+
+// Igual, mas no fim do fluxo: o que passar do fim vem com zeros
+static uint64_t bitstream_peek(const HuffBitStream* s) {
+    size_t byte = (size_t)(s->bit_pos >> 3);
+    if (byte + 8 <= s->size) return bitstream_peek_fast(s);
+
+    uint64_t v = 0;
+    for (int i = 0; i < 8 && byte + i < s->size; i++) v |= (uint64_t)s->data[byte + i] << (56 - 8 * i);
+    return v << (s->bit_pos & 7);
+}
+
+// Um símbolo a partir de *acc (consome os bits dele). Código inválido: *bad = 1
+static inline unsigned char interleaved_symbol(const HuffDecodeTable* table, uint64_t* acc, uint64_t* bit_pos, int* bad) {
+    HuffLookupEntry entry = table->entries[*acc >> (64 - HUFF_LOOKUP_BITS)];
+    int symbol = entry.symbol;
+    int length = entry.length;
+    if (length == 0) {
+        symbol = decode_long_code(table, *acc, &length);
+        if (length == 0) {
+            *bad = 1;
+            length = 1; //só para andar; o pedaço já foi marcado como corrompido
+        }
+    }
+    *acc <<= length;
+    *bit_pos += length;
+    return (unsigned char)symbol;
+}
+
+/*Decodifica os 4 fluxos de um pedaço intercalado (payload = tabela de saltos + fluxos)
+direto em out[0 .. n-1]. Retorna 1 se deu certo.*/
+int huff_decode_interleaved(const unsigned char* payload, size_t size, const HuffDecodeTable* table, unsigned char* out, size_t n) {
+    if (size < HUFF_INTERLEAVED_JUMP_SIZE) return 0;
+    HUFF_PROFILE_BEGIN(profile);
+
+    HuffBitStream s[HUFF_INTERLEAVED_STREAMS];
+    unsigned char* o[HUFF_INTERLEAVED_STREAMS];
+    unsigned char* e[HUFF_INTERLEAVED_STREAMS];
+    size_t offset = HUFF_INTERLEAVED_JUMP_SIZE;
+
+    for (int k = 0; k < HUFF_INTERLEAVED_STREAMS; k++) {
+        size_t length = k < HUFF_INTERLEAVED_STREAMS - 1 ? huff_get_u32(payload + 4 * k) : size - offset;
+        if (length > size - offset) return 0;
+        s[k].data = payload + offset;
+        s[k].size = length;
+        s[k].bit_pos = 0;
+        offset += length;
+
+        size_t start, end;
+        interleaved_quarter(n, k, &start, &end);
+        o[k] = out + start;
+        e[k] = out + end;
+    }
+
+    /*1. Caminho rápido: 3 símbolos por fluxo a cada leitura (3 × 19 bits <= 57).
+    Os 4 fluxos avançam juntos enquanto todos têm 8 bytes pela frente e 3 símbolos por escrever.
+    O quarto 3 é o menor, então é ele que acaba primeiro.
+    Os comprimentos vêm do arquivo e podem ir até 32 bits: com algum código maior que 19,
+    tudo vai pelo passo 2, um símbolo por leitura.*/
+    int bad = 0;
+    int fast = table->max_length <= HUFF_INTERLEAVED_FAST_MAX_LENGTH;
+    while (fast && e[3] - o[3] >= 3 &&
+           (s[0].bit_pos >> 3) + 8 <= s[0].size && (s[1].bit_pos >> 3) + 8 <= s[1].size &&
+           (s[2].bit_pos >> 3) + 8 <= s[2].size && (s[3].bit_pos >> 3) + 8 <= s[3].size) {
+        uint64_t a0 = bitstream_peek_fast(&s[0]);
+        uint64_t a1 = bitstream_peek_fast(&s[1]);
+        uint64_t a2 = bitstream_peek_fast(&s[2]);
+        uint64_t a3 = bitstream_peek_fast(&s[3]);
+        for (int r = 0; r < 3; r++) {
+            *o[0]++ = interleaved_symbol(table, &a0, &s[0].bit_pos, &bad);
+            *o[1]++ = interleaved_symbol(table, &a1, &s[1].bit_pos, &bad);
+            *o[2]++ = interleaved_symbol(table, &a2, &s[2].bit_pos, &bad);
+            *o[3]++ = interleaved_symbol(table, &a3, &s[3].bit_pos, &bad);
+        }
+    }
+
+    // 2. O que sobrou de cada fluxo, um símbolo por vez
+    for (int k = 0; k < HUFF_INTERLEAVED_STREAMS; k++) {
+        while (o[k] < e[k] && !bad) {
+            uint64_t acc = bitstream_peek(&s[k]);
+            *o[k]++ = interleaved_symbol(table, &acc, &s[k].bit_pos, &bad);
+        }
+        if (s[k].bit_pos > (uint64_t)s[k].size * 8) bad = 1; //leu além do fim: fluxo truncado
+    }
+
+    HUFF_PROFILE_END(profile, HUFF_STAGE_DECODE, n);
+    return !bad;
+}
+
+/*Compacta um pedaço inteiro em memória: frequências → comprimentos limitados → códigos canônicos → bits.
+chunk->mode pede o modo: HUFF_CHUNK_INTERLEAVED gera 4 fluxos, qualquer outro valor gera HUFF_CHUNK_CANONICAL.
+Se os bits não ficarem menores que o pedaço, ele é guardado como está (HUFF_CHUNK_STORED).*/
+void compress_chunk_task(void* ctx, size_t index) {
+    HuffChunk* chunk = &((HuffChunk*)ctx)[index];
+
+    uint64_t freq[256] = {0};
+    count_frequencies(chunk->input, chunk->input_size, freq); //cada thread já é um pedaço: contagem serial com bancos
+
+    HuffmanCode huff_table[256];
+    unsigned char lengths[256];
+
+    int interleaved = chunk->mode == HUFF_CHUNK_INTERLEAVED;
+    chunk->mode = interleaved ? HUFF_CHUNK_INTERLEAVED : HUFF_CHUNK_CANONICAL;
+    int max_length = interleaved ? HUFF_INTERLEAVED_MAX_LENGTH : HUFF_MAX_CODE_LENGTH;
+    if (!huff_code_lengths(freq, max_length, HUFF_DEFAULT_BUILDER, lengths) ||
+        !build_canonical_codes(lengths, huff_table)) {
+        chunk->failed = 1;
+        return;
+    }
+
+    //cada fluxo intercalado pode gastar até 1 byte a mais completando o último byte
+    size_t overhead = code_lengths_size(lengths) + (interleaved ? HUFF_INTERLEAVED_JUMP_SIZE + HUFF_INTERLEAVED_STREAMS - 1 : 0);
+    if (huff_store_is_smaller(huff_block_cost(freq, lengths), overhead, chunk->input_size)) {
+        chunk->mode = HUFF_CHUNK_STORED;
+        chunk->failed = !huff_writer_open_memory(&chunk->output, chunk->input_size + 1);
+        if (!chunk->failed) huff_write_bytes(&chunk->output, chunk->input, chunk->input_size);
+        return;
+    }
+
+    if (!huff_writer_open_memory(&chunk->output, chunk->input_size / 2 + 1024)) { //chute inicial, cresce se precisar
+        chunk->failed = 1;
+        return;
+    }
+
+    write_code_lengths(&chunk->output, lengths);
+
+    if (interleaved) {
+        encode_interleaved(chunk->input, chunk->input_size, huff_table, &chunk->output);
+    } else {
+        BitWriter bits = {0, 0};
+        huff_encode_block(chunk->input, chunk->input_size, huff_table, &bits, &chunk->output);
+        bit_writer_finish(&bits, &chunk->output);
+    }
+
+    chunk->failed = chunk->output.error;
+}
+
+// Descompacta um pedaço inteiro em memória, direto para um bloco do tamanho original
+void decompress_chunk_task(void* ctx, size_t index) {
+    HuffChunk* chunk = &((HuffChunk*)ctx)[index];
+
+    chunk->failed = 1;
+    if (chunk->mode == HUFF_CHUNK_STORED) { //decompress_chunked() copia direto do payload (ou aqui, para a saída mapeada)
+        if (chunk->packed_size != chunk->input_size) return;
+        if (chunk->destination) memcpy(chunk->destination, chunk->packed_input, chunk->input_size);
+        chunk->failed = 0;
+        return;
+    }
+    //saída mapeada: decodifica direto no lugar do pedaço dentro do arquivo, sem bloco intermediário
+    if (chunk->destination) huff_writer_open_fixed(&chunk->output, chunk->destination, chunk->input_size);
+    else if (!huff_writer_open_memory(&chunk->output, chunk->input_size)) return;
+    if (chunk->input_size == 0) {
+        chunk->failed = 0;
+        return;
+    }
+    if (chunk->mode != HUFF_CHUNK_TREE && chunk->mode != HUFF_CHUNK_CANONICAL && chunk->mode != HUFF_CHUNK_INTERLEAVED) return;
+
+    HuffReader reader;
+    huff_reader_open_memory(&reader, chunk->packed_input, chunk->packed_size);
+
+    HuffDecodeTable* table = malloc(sizeof(HuffDecodeTable));
+    NODE_POOL* pool = NULL;
+    int ready = 0;
+
+    if (table && chunk->mode != HUFF_CHUNK_TREE) {
+        unsigned char lengths[256];
+        ready = read_code_lengths(&reader, lengths) && build_decode_table_from_lengths(lengths, table);
+    } else if (table && (pool = create_node_pool())) {
+        int bytes_read = 0;
+        NODE* root = read_tree(&reader, &bytes_read, pool); //a tabela aponta para os nós: o pool vive até o fim
+        if (root) {
+            build_decode_table(root, table);
+            ready = 1;
+        }
+    }
+
+    if (ready && chunk->mode == HUFF_CHUNK_INTERLEAVED) {
+        //os comprimentos já foram lidos: o resto do payload são a tabela de saltos e os fluxos
+        if (huff_decode_interleaved(reader.data + reader.pos, reader.len - reader.pos, table, chunk->output.data, chunk->input_size)) {
+            chunk->output.pos = chunk->input_size;
+            chunk->failed = 0;
+        }
+    } else if (ready) {
+        uint64_t written = huff_decode_stream(&reader, &chunk->output, table, INT64_MAX, chunk->input_size);
+        chunk->failed = (written != chunk->input_size);
+    }
+
+    free(table);
+    free_node_pool(pool);
+    huff_reader_close(&reader);
+}
+
+void write_chunked_header(HuffWriter* writer, size_t chunk_size) {
+    huff_write_bytes(writer, (const unsigned char*)HUFF_CHUNKED_MAGIC, 4);
+    huff_write_byte(writer, HUFF_CHUNKED_VERSION);
+    huff_write_byte(writer, 0); //flags
+    huff_write_byte(writer, 0);
+    huff_write_byte(writer, 0);
+    huff_write_u32(writer, (uint32_t)chunk_size);
+    huff_write_u32(writer, 0);
+}
+
+// Escreve um pedaço já compactado (registro + payload). Retorna quantos bytes ele ocupa no arquivo
+uint64_t write_chunk_record(HuffWriter* writer, const HuffChunk* chunk) {
+    huff_write_u32(writer, (uint32_t)chunk->input_size);
+    huff_write_u32(writer, (uint32_t)chunk->output.pos);
+    huff_write_byte(writer, chunk->mode);
+    huff_write_bytes(writer, chunk->output.data, chunk->output.pos);
+    return HUFF_CHUNKED_RECORD_SIZE + chunk->output.pos;
+}
+
+// Índice (offsets de cada pedaço) e rodapé; index_offset = onde o índice começa (logo depois do último pedaço)
+void write_chunked_footer(HuffWriter* writer, const uint64_t* offsets, size_t chunk_count, uint64_t index_offset, uint64_t original_size) {
+    for (size_t i = 0; i < chunk_count; i++) {
+        huff_write_u64(writer, offsets[i]);
+    }
+    huff_write_u64(writer, index_offset);
+    huff_write_u64(writer, original_size);
+    huff_write_u32(writer, (uint32_t)chunk_count);
+    huff_write_bytes(writer, (const unsigned char*)HUFF_CHUNKED_INDEX_MAGIC, 4);
+}
+
+/*Compacta input em pedaços de chunk_size bytes usando threads (<= 0 = todos os núcleos).
+mode: HUFF_CHUNK_CANONICAL ou HUFF_CHUNK_INTERLEAVED. Retorna 1 se deu certo.*/
+int compress_chunked(FILE* input, FILE* output, size_t chunk_size, int threads, unsigned char mode) {
+    if (chunk_size == 0) chunk_size = HUFF_CHUNK_SIZE;
+    if (chunk_size > UINT32_MAX) chunk_size = UINT32_MAX;
+
+    HuffPool* pool = huff_pool_create(threads);
+    if (!pool) return 0;
+
+    size_t batch_size = (size_t)pool->thread_count * HUFF_CHUNK_BATCH_PER_THREAD;
+    HuffChunk* chunks = calloc(batch_size, sizeof(HuffChunk));
+    uint64_t* offsets = NULL;
+    size_t chunk_count = 0, offsets_capacity = 0;
+    uint64_t position = 0, original_size = 0;
+    unsigned char* scratch = NULL;
+    int ok = 1;
+
+    HuffReader reader;
+    HuffWriter writer;
+    if (!chunks || !huff_reader_open_mapped(&reader, input)) {
+        free(chunks);
+        huff_pool_destroy(pool);
+        return 0;
+    }
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        free(chunks);
+        huff_pool_destroy(pool);
+        return 0;
+    }
+
+    //Arquivo mapeado: cada pedaço aponta direto para o mapeamento. Senão, os pedaços são copiados para scratch
+    if (!reader.map) {
+        scratch = malloc(batch_size * chunk_size);
+        if (!scratch) ok = 0;
+    }
+
+    // 1. Cabeçalho
+    write_chunked_header(&writer, chunk_size);
+    position = HUFF_CHUNKED_HEADER_SIZE;
+
+    while (ok) {
+        // 2. Separa até batch_size pedaços
+        size_t n = 0;
+        while (n < batch_size) {
+            const unsigned char* data;
+            size_t got = huff_reader_take(&reader, chunk_size, scratch ? scratch + n * chunk_size : NULL, &data);
+            if (got == 0) break;
+
+            chunks[n].input = data;
+            chunks[n].input_size = got;
+            chunks[n].mode = mode;
+            chunks[n].failed = 0;
+            n++;
+            if (got < chunk_size) break; //último pedaço
+        }
+        if (n == 0) break;
+
+        // 3. Compacta todos em paralelo
+        huff_pool_run(pool, n, compress_chunk_task, chunks);
+
+        // 4. Escreve na ordem original, anotando onde cada pedaço começa
+        for (size_t i = 0; i < n; i++) {
+            if (chunks[i].failed) ok = 0;
+
+            if (ok && chunk_count == offsets_capacity) {
+                offsets_capacity = offsets_capacity ? offsets_capacity * 2 : 64;
+                uint64_t* bigger = realloc(offsets, offsets_capacity * sizeof(uint64_t));
+                if (!bigger) ok = 0;
+                else offsets = bigger;
+            }
+
+            if (ok) {
+                offsets[chunk_count++] = position;
+                position += write_chunk_record(&writer, &chunks[i]);
+                original_size += chunks[i].input_size;
+            }
+            huff_writer_close(&chunks[i].output);
+        }
+    }
+
+    // 5. Índice e rodapé
+    if (ok) write_chunked_footer(&writer, offsets, chunk_count, position, original_size);
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    free(scratch);
+    free(offsets);
+    free(chunks);
+    huff_pool_destroy(pool);
+    return ok;
+}
+
+/*Lê o rodapé e o índice. Retorna a lista de posições dos pedaços (o chamador libera)
+ou NULL se o arquivo não for um .huff em pedaços válido.*/
+uint64_t* read_chunk_index(FILE* input, uint32_t* chunk_count, uint64_t* original_size) {
+    unsigned char footer[HUFF_CHUNKED_FOOTER_SIZE];
+
+    uint64_t file_size;
+    if (!huff_file_size(input, &file_size) || file_size < HUFF_CHUNKED_HEADER_SIZE + HUFF_CHUNKED_FOOTER_SIZE) return NULL;
+
+    if (!huff_seek(input, file_size - HUFF_CHUNKED_FOOTER_SIZE)) return NULL;
+    if (fread(footer, 1, sizeof(footer), input) != sizeof(footer)) return NULL;
+    if (memcmp(footer + 20, HUFF_CHUNKED_INDEX_MAGIC, 4) != 0) return NULL;
+
+    uint64_t index_offset = huff_get_u64(footer);
+    *original_size = huff_get_u64(footer + 8);
+    *chunk_count = huff_get_u32(footer + 16);
+
+    //o índice precisa caber exatamente entre o último pedaço e o rodapé (sem somar: um index_offset enorme daria a volta)
+    if (index_offset < HUFF_CHUNKED_HEADER_SIZE || index_offset > file_size - HUFF_CHUNKED_FOOTER_SIZE ||
+        file_size - HUFF_CHUNKED_FOOTER_SIZE - index_offset != (uint64_t)*chunk_count * 8) {
+        return NULL;
+    }
+
+    uint64_t* offsets = malloc(((size_t)*chunk_count + 1) * sizeof(uint64_t));
+    unsigned char raw[8];
+    if (!offsets) return NULL;
+
+    huff_seek(input, index_offset);
+    for (uint32_t i = 0; i < *chunk_count; i++) {
+        if (fread(raw, 1, 8, input) != 8) {
+            free(offsets);
+            return NULL;
+        }
+        offsets[i] = huff_get_u64(raw);
+
+        //os pedaços vêm em ordem, depois do cabeçalho e antes do índice: fora disso o índice está corrompido
+        uint64_t previous = i > 0 ? offsets[i - 1] : HUFF_CHUNKED_HEADER_SIZE;
+        if (offsets[i] < previous || offsets[i] > index_offset) {
+            free(offsets);
+            return NULL;
+        }
+    }
+    offsets[*chunk_count] = index_offset; //sentinela: onde o último pedaço termina
+    return offsets;
+}
+
+// Descompacta um arquivo gerado por compress_chunked(), pedaços em paralelo. Retorna 1 se deu certo
+int decompress_chunked(FILE* input, FILE* output) {
+    unsigned char header[HUFF_CHUNKED_HEADER_SIZE];
+    rewind(input);
+    if (fread(header, 1, sizeof(header), input) != sizeof(header)) return 0;
+    if (memcmp(header, HUFF_CHUNKED_MAGIC, 4) != 0 || header[4] != HUFF_CHUNKED_VERSION) return 0;
+    uint32_t chunk_size = huff_get_u32(header + 8);
+
+    uint32_t chunk_count = 0;
+    uint64_t original_size = 0;
+    uint64_t* offsets = read_chunk_index(input, &chunk_count, &original_size);
+    if (!offsets) return 0;
+    if (original_size > (uint64_t)chunk_count * chunk_size) { //nenhum pedaço passa de chunk_size: rodapé corrompido
+        free(offsets);
+        return 0;
+    }
+
+    HuffPool* pool = huff_pool_create(0);
+    size_t batch_size = pool ? (size_t)pool->thread_count * HUFF_CHUNK_BATCH_PER_THREAD : 0;
+    HuffChunk* chunks = batch_size ? calloc(batch_size, sizeof(HuffChunk)) : NULL;
+    unsigned char** copies = batch_size ? calloc(batch_size, sizeof(unsigned char*)) : NULL;
+    uint64_t total = 0;
+    int ok = chunks && copies;
+
+    HuffReader reader;
+    HuffWriter writer;
+    rewind(input);
+    if (ok && !huff_reader_open_mapped(&reader, input)) ok = 0;
+    if (ok && !huff_writer_open_sized(&writer, output, original_size)) { //arquivo comum: saída mapeada (ver huff_io.h)
+        huff_reader_close(&reader);
+        ok = 0;
+    }
+    if (!ok) {
+        free(copies);
+        free(chunks);
+        free(offsets);
+        huff_pool_destroy(pool);
+        return 0;
+    }
+    if (reader.map) huff_reader_refill(&reader); //reader.data = arquivo inteiro
+
+    for (uint32_t first = 0; ok && first < chunk_count; first += batch_size) {
+        size_t n = chunk_count - first < batch_size ? chunk_count - first : batch_size;
+
+        // 1. Localiza cada pedaço pelo índice
+        uint64_t destination = total; //onde o próximo pedaço começa na saída
+        for (size_t i = 0; i < n && ok; i++) {
+            uint64_t start = offsets[first + i];
+            uint64_t end = offsets[first + i + 1];
+            if (start < HUFF_CHUNKED_HEADER_SIZE || end < start + HUFF_CHUNKED_RECORD_SIZE) {
+                ok = 0;
+                break;
+            }
+
+            const unsigned char* record;
+            if (reader.map) { //arquivo mapeado: aponta direto, sem copiar
+                record = reader.data + start;
+            } else {
+                copies[i] = malloc(end - start);
+                if (!copies[i]) { ok = 0; break; }
+                if (!huff_seek(input, start) || fread(copies[i], 1, end - start, input) != end - start) { ok = 0; break; }
+                record = copies[i];
+            }
+
+            chunks[i].input_size = huff_get_u32(record);
+            chunks[i].packed_size = huff_get_u32(record + 4);
+            chunks[i].mode = record[8];
+            chunks[i].packed_input = record + HUFF_CHUNKED_RECORD_SIZE;
+            if (chunks[i].packed_size != end - start - HUFF_CHUNKED_RECORD_SIZE) ok = 0;
+            if (chunks[i].input_size > chunk_size) ok = 0;
+
+            chunks[i].destination = NULL;
+            if (ok && chunks[i].input_size > original_size - destination) { ok = 0; break; } //pedaços passam do total do rodapé
+            if (ok && writer.map) chunks[i].destination = writer.data + destination;
+            destination += chunks[i].input_size;
+        }
+
+        // 2. Descompacta todos em paralelo
+        if (ok) huff_pool_run(pool, n, decompress_chunk_task, chunks);
+
+        // 3. Escreve na ordem original (saída mapeada: os pedaços já estão no lugar, só avança)
+        for (size_t i = 0; i < n; i++) {
+            if (ok && chunks[i].failed) ok = 0;
+            if (ok && chunks[i].destination) {
+                writer.pos += chunks[i].input_size;
+                total += chunks[i].input_size;
+            } else if (ok && chunks[i].mode == HUFF_CHUNK_STORED) { //uma cópia só, do arquivo (mapeado) para a saída
+                huff_write_bytes(&writer, chunks[i].packed_input, chunks[i].packed_size);
+                total += chunks[i].packed_size;
+            } else if (ok) {
+                huff_write_bytes(&writer, chunks[i].output.data, chunks[i].output.pos);
+                total += chunks[i].output.pos;
+            }
+            if (chunks[i].output.data) huff_writer_close(&chunks[i].output);
+            free(copies[i]);
+            copies[i] = NULL;
+        }
+    }
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    if (total != original_size) ok = 0;
+
+    huff_reader_close(&reader);
+    free(copies);
+    free(chunks);
+    free(offsets);
+    huff_pool_destroy(pool);
+    return ok;
+}
+
+#endif // HUFF_CHUNKED_H
@@ -0,0 +1,197 @@
+/*
+    CONTEXTO REAPROVEITÁVEL (muitos arquivos no mesmo processo)
+
+    compress_canonical() e decompact() servem para um arquivo por vez: cada
+    chamada abre blocos de leitura e escrita, aloca a tabela de decodificação
+    e libera tudo no final. Para milhares de arquivos pequenos, esse
+    malloc/free por arquivo (e iniciar o programa de novo para cada um) pesa
+    mais que a compactação em si.
+
+    O huff_ctx é criado uma vez e guarda tudo que pode ser reaproveitado:
+    - input:  o arquivo inteiro lido na memória (só cresce, nunca diminui);
+    - output: o resultado, um HuffWriter em memória (também só cresce);
+    - table:  a tabela de decodificação (HuffDecodeTable).
+    Depois que os buffers chegaram ao tamanho do maior arquivo, compactar ou
+    descompactar não aloca mais nada. As frequências, os comprimentos e os
+    códigos ficam na pilha; as duas filas (huff_two_queue.h) não usam malloc.
+
+    huff_ctx* ctx = huff_ctx_create();
+    for (...) huff_ctx_compress_file(ctx, nome, nome_saida);
+    huff_ctx_free(ctx);
+
+    O formato gerado é o canônico (huff_canonical.h), ou o guardado
+    (huff_stored.h) quando não encolhe: decompact() e decompress_file()
+    também os reconhecem.
+
+    Não é seguro usar o mesmo huff_ctx em duas threads ao mesmo tempo:
+    crie um por thread.
+*/
+
+#ifndef HUFF_CTX_H
+#define HUFF_CTX_H
+
+#include "huffman.h"
+
+// Cabeçalho canônico: 13 bytes fixos + no máximo 1 + 256 × 6 / 8 = 193 de comprimentos (o guardado tem só 13)
+#define HUFF_CTX_HEADER_SLACK 256
+
+typedef struct {
+    unsigned char* input;     //arquivo lido por huff_ctx_*_file()
+    size_t input_capacity;
+    HuffWriter output;        //resultado da última chamada (válido até a próxima)
+    HuffDecodeTable* table;
+} huff_ctx;
+
+// Retorna NULL se faltar memória
+huff_ctx* huff_ctx_create(void) {
+    huff_ctx* ctx = malloc(sizeof(huff_ctx));
+    if (!ctx) return NULL;
+
+    ctx->input = NULL;
+    ctx->input_capacity = 0;
+    ctx->table = malloc(sizeof(HuffDecodeTable));
+    if (!ctx->table || !huff_writer_open_memory(&ctx->output, HUFF_IO_BLOCK_SIZE)) {
+        free(ctx->table);
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void huff_ctx_free(huff_ctx* ctx) {
+    if (ctx == NULL) return;
+    huff_writer_close(&ctx->output);
+    free(ctx->input);
+    free(ctx->table);
+    free(ctx);
+}
+
+// Esvazia a saída mantendo o bloco, com espaço para pelo menos size bytes
+static int huff_ctx_reset_output(huff_ctx* ctx, size_t size) {
+    ctx->output.pos = 0;
+    ctx->output.error = 0;
+    return huff_writer_reserve(&ctx->output, size);
+}
+
+/*Compacta os n bytes de in. O resultado fica em *out (*out_size bytes), dentro do
+contexto: continua válido até a próxima chamada. Retorna 1 se deu certo.*/
+int huff_ctx_compress(huff_ctx* ctx, const unsigned char* in, size_t n, const unsigned char** out, size_t* out_size) {
+    //um código de Huffman nunca gasta mais que 8 bits por byte em média: n bytes de bits bastam
+    if (!huff_ctx_reset_output(ctx, n + HUFF_CTX_HEADER_SLACK)) return 0;
+    if (!huff_canonical_encode(in, n, &ctx->output)) return 0;
+
+    *out = ctx->output.data;
+    *out_size = ctx->output.pos;
+    return 1;
+}
+
+/*Descompacta os n bytes de in (formato canônico ou guardado). Mesmas regras de huff_ctx_compress().
+Retorna 0 se não for um desses formatos ou se estiver corrompido.*/
+int huff_ctx_decompress(huff_ctx* ctx, const unsigned char* in, size_t n, const unsigned char** out, size_t* out_size) {
+    if (n >= 4 && memcmp(in, HUFF_STORED_MAGIC, 4) == 0) {
+        if (!huff_ctx_reset_output(ctx, n) || !huff_stored_decode(in, n, &ctx->output)) return 0;
+        *out = ctx->output.data;
+        *out_size = ctx->output.pos;
+        return 1;
+    }
+    if (n < HUFF_CANONICAL_HEADER_SIZE || memcmp(in, HUFF_CANONICAL_MAGIC, 4) != 0) return 0;
+
+    //cada bit gera no máximo um byte: um tamanho maior que isso só pode ser cabeçalho corrompido
+    uint64_t original_size = huff_get_u64(in + 5);
+    if (original_size > (uint64_t)n * 8) return 0;
+    if (!huff_ctx_reset_output(ctx, (size_t)original_size)) return 0;
+
+    HuffReader reader;
+    huff_reader_open_memory(&reader, in, n);
+    int ok = huff_canonical_decode(&reader, &ctx->output, ctx->table, NULL) && !ctx->output.error;
+    huff_reader_close(&reader);
+    if (!ok) return 0;
+
+    *out = ctx->output.data;
+    *out_size = ctx->output.pos;
+    return 1;
+}
+
+// Lê o arquivo inteiro para ctx->input (aumentando o buffer só se precisar). Retorna 0 se der erro
+static int huff_ctx_read_file(huff_ctx* ctx, FILE* file, size_t* size) {
+    uint64_t end;
+    if (!huff_file_size(file, &end) || end > SIZE_MAX) return 0;
+    rewind(file);
+
+    if ((size_t)end > ctx->input_capacity) {
+        unsigned char* bigger = realloc(ctx->input, (size_t)end);
+        if (!bigger) {
+            perror("Erro ao alocar buffer de leitura");
+            return 0;
+        }
+        ctx->input = bigger;
+        ctx->input_capacity = (size_t)end;
+    }
+
+    *size = fread(ctx->input, 1, (size_t)end, file);
+    return *size == (size_t)end;
+}
+
+// Grava a saída do contexto em output_path
+static int huff_ctx_write_output(huff_ctx* ctx, const char* output_path) {
+    FILE* output = fopen(output_path, "wb");
+    if (!output) {
+        perror("Erro ao criar o arquivo de saída");
+        return 0;
+    }
+    int ok = fwrite(ctx->output.data, 1, ctx->output.pos, output) == ctx->output.pos;
+    if (fclose(output) != 0) ok = 0;
+    return ok;
+}
+
+// Compacta input_path em output_path (formato canônico). Retorna 1 se deu certo
+int huff_ctx_compress_file(huff_ctx* ctx, const char* input_path, const char* output_path) {
+    FILE* input = fopen(input_path, "rb");
+    if (!input) {
+        perror("Erro ao abrir o arquivo");
+        return 0;
+    }
+
+    size_t size = 0;
+    const unsigned char* out;
+    size_t out_size;
+    int ok = huff_ctx_read_file(ctx, input, &size) && huff_ctx_compress(ctx, ctx->input, size, &out, &out_size);
+    fclose(input);
+
+    return ok && huff_ctx_write_output(ctx, output_path);
+}
+
+/*Descompacta input_path em output_path. Os formatos canônico e guardado usam os
+buffers do contexto; os outros vão para decompress_file(). Retorna 1 se deu certo.*/
+int huff_ctx_decompress_file(huff_ctx* ctx, const char* input_path, const char* output_path) {
+    FILE* input = fopen(input_path, "rb");
+    if (!input) {
+        perror("Erro ao abrir o arquivo");
+        return 0;
+    }
+
+    HuffFormat format = detect_format(input);
+    if (format != HUFF_FORMAT_CANONICAL && format != HUFF_FORMAT_STORED) {
+        FILE* output = fopen(output_path, "w+b"); //"+": a saída pode ser mapeada (huff_writer_open_sized)
+        if (!output) {
+            perror("Erro ao criar o arquivo de saída");
+            fclose(input);
+            return 0;
+        }
+        int ok = decompress_file(input, output);
+        if (fclose(output) != 0) ok = 0;
+        fclose(input);
+        if (!ok) remove(output_path); //não deixa um arquivo pela metade
+        return ok;
+    }
+
+    size_t size = 0;
+    const unsigned char* out;
+    size_t out_size;
+    int ok = huff_ctx_read_file(ctx, input, &size) && huff_ctx_decompress(ctx, ctx->input, size, &out, &out_size);
+    fclose(input);
+
+    return ok && huff_ctx_write_output(ctx, output_path);
+}
+
+#endif // HUFF_CTX_H
@@ -0,0 +1,218 @@
+/*
+    DICIONÁRIO PRÉ-TREINADO (mensagens pequenas)
+
+    Numa mensagem de 200 bytes, a árvore em pré-ordem que write_header()
+    escreve pode ser maior que a própria mensagem, e montar uma árvore por
+    mensagem custa mais que codificá-la. Quando as mensagens se parecem
+    (logs, JSON, protocolos), dá para montar a tabela UMA vez a partir de um
+    corpus de exemplo e usar a mesma tabela em todas:
+
+    1. Treino: soma as frequências de todos os arquivos do corpus (+1 em cada
+       byte, para que um byte que nunca apareceu no corpus ainda tenha código)
+       e guarda os comprimentos num arquivo de dicionário.
+    2. Compactação/descompactação: os dois lados carregam o mesmo dicionário;
+       a mensagem leva só o ID dele, sem árvore nem comprimentos.
+
+    O ID é um hash (FNV-1a) dos 256 comprimentos: dois dicionários com a mesma
+    tabela têm o mesmo ID, e descompactar com o dicionário errado é detectado.
+
+    Arquivo de dicionário:  "HDIC" | versão (1 byte) | ID (u32) | comprimentos (write_code_lengths)
+    Mensagem compactada:    "HUFD" | ID (u32) | tamanho original (u32) | bits
+
+    Depois de carregado, o HuffDictionary já tem os códigos e a tabela de
+    decodificação prontos: huff_dict_compress()/huff_dict_decompress() não
+    alocam nada se o HuffWriter em memória já tiver espaço (reaproveite o
+    mesmo writer entre mensagens).
+*/
+
+#ifndef HUFF_DICTIONARY_H
+#define HUFF_DICTIONARY_H
+
+#include "huffman.h"
+
+#define HUFF_DICTIONARY_FILE_MAGIC "HDIC"
+#define HUFF_DICTIONARY_VERSION 1
+#define HUFF_DICTIONARY_HEADER_SIZE 12 //magic + ID + tamanho original
+
+typedef struct {
+    uint32_t id;
+    unsigned char lengths[256];
+    HuffmanCode codes[256];
+    HuffDecodeTable table;
+} HuffDictionary;
+
+// FNV-1a de 32 bits sobre os comprimentos
+uint32_t huff_dict_id(const unsigned char lengths[256]) {
+    uint32_t hash = 2166136261u;
+    for (int s = 0; s < 256; s++) {
+        hash ^= lengths[s];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Comprimentos → ID, códigos canônicos e tabela de decodificação
+static int huff_dict_prepare(HuffDictionary* dict) {
+    dict->id = huff_dict_id(dict->lengths);
+    return build_canonical_codes(dict->lengths, dict->codes) && build_decode_table_from_lengths(dict->lengths, &dict->table);
+}
+
+/*Monta o dicionário a partir das frequências somadas do corpus.
+Todos os 256 bytes recebem código (frequência + 1). Retorna 1 se deu certo.*/
+int huff_dict_from_frequencies(const uint64_t corpus_freq[256], HuffDictionary* dict) {
+    uint64_t freq[256];
+    for (int s = 0; s < 256; s++) freq[s] = corpus_freq[s] + 1;
+
+    if (!huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, dict->lengths)) return 0;
+    return huff_dict_prepare(dict);
+}
+
+// Treina com uma lista de arquivos de exemplo. Retorna 1 se deu certo
+int huff_dict_train_files(char* const paths[], size_t count, HuffDictionary* dict) {
+    uint64_t freq[256] = {0};
+
+    for (size_t i = 0; i < count; i++) {
+        FILE* file = fopen(paths[i], "rb");
+        if (!file) {
+            perror(paths[i]);
+            return 0;
+        }
+
+        HuffReader reader;
+        if (!huff_reader_open_mapped(&reader, file)) {
+            fclose(file);
+            return 0;
+        }
+        size_t got;
+        while ((got = huff_reader_refill(&reader)) > 0) count_frequencies(reader.data, got, freq);
+        huff_reader_close(&reader);
+        fclose(file);
+    }
+    return huff_dict_from_frequencies(freq, dict);
+}
+
+int huff_dict_save(const HuffDictionary* dict, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        perror("Erro ao criar o dicionário");
+        return 0;
+    }
+
+    HuffWriter writer;
+    if (!huff_writer_open(&writer, file, 0)) {
+        fclose(file);
+        return 0;
+    }
+    huff_write_bytes(&writer, (const unsigned char*)HUFF_DICTIONARY_FILE_MAGIC, 4);
+    huff_write_byte(&writer, HUFF_DICTIONARY_VERSION);
+    huff_write_u32(&writer, dict->id);
+    write_code_lengths(&writer, dict->lengths);
+
+    int ok = huff_writer_close(&writer);
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+// Retorna 0 se o arquivo não for um dicionário válido
+int huff_dict_load(HuffDictionary* dict, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror("Erro ao abrir o dicionário");
+        return 0;
+    }
+
+    HuffReader reader;
+    if (!huff_reader_open(&reader, file, 0)) {
+        fclose(file);
+        return 0;
+    }
+
+    unsigned char scratch[9];
+    const unsigned char* header;
+    int ok = huff_reader_take(&reader, sizeof(scratch), scratch, &header) == sizeof(scratch) &&
+             memcmp(header, HUFF_DICTIONARY_FILE_MAGIC, 4) == 0 && header[4] == HUFF_DICTIONARY_VERSION;
+    uint32_t id = ok ? huff_get_u32(header + 5) : 0;
+
+    ok = ok && read_code_lengths(&reader, dict->lengths) && huff_dict_prepare(dict) && dict->id == id;
+    huff_reader_close(&reader);
+    fclose(file);
+
+    if (!ok) fprintf(stderr, "Erro: dicionário inválido: %s\n", path);
+    return ok;
+}
+
+/*Compacta os n bytes de in com o dicionário, acrescentando o resultado a out.
+Retorna 1 se deu certo (mensagens de até 4 GiB).*/
+int huff_dict_compress(const HuffDictionary* dict, const unsigned char* in, size_t n, HuffWriter* out) {
+    if ((uint64_t)n > UINT32_MAX) return 0;
+
+    huff_write_bytes(out, (const unsigned char*)HUFF_DICTIONARY_MAGIC, 4);
+    huff_write_u32(out, dict->id);
+    huff_write_u32(out, (uint32_t)n);
+
+    BitWriter bits = {0, 0};
+    huff_encode_block(in, n, dict->codes, &bits, out);
+    bit_writer_finish(&bits, out);
+    return !out->error;
+}
+
+/*Descompacta uma mensagem gerada por huff_dict_compress(), acrescentando o original a out.
+Retorna 0 se a mensagem estiver corrompida ou tiver sido compactada com outro dicionário.*/
+int huff_dict_decompress(const HuffDictionary* dict, const unsigned char* in, size_t n, HuffWriter* out) {
+    if (n < HUFF_DICTIONARY_HEADER_SIZE || memcmp(in, HUFF_DICTIONARY_MAGIC, 4) != 0) return 0;
+    if (huff_get_u32(in + 4) != dict->id) {
+        fprintf(stderr, "Erro: a mensagem foi compactada com outro dicionário\n");
+        return 0;
+    }
+    uint32_t original_size = huff_get_u32(in + 8);
+
+    HuffReader reader;
+    huff_reader_open_memory(&reader, in + HUFF_DICTIONARY_HEADER_SIZE, n - HUFF_DICTIONARY_HEADER_SIZE);
+    uint64_t written = huff_decode_stream(&reader, out, &dict->table, INT64_MAX, original_size);
+    huff_reader_close(&reader);
+    return written == original_size && !out->error;
+}
+
+// Lê o arquivo inteiro num writer em memória (mensagens são pequenas)
+static int huff_dict_read_all(FILE* input, HuffWriter* buffer) {
+    unsigned char block[4096];
+    size_t got;
+    while ((got = fread(block, 1, sizeof(block), input)) > 0) huff_write_bytes(buffer, block, got);
+    return !ferror(input) && !buffer->error;
+}
+
+// Versões com arquivos. Retornam 1 se deu certo
+int compress_dictionary(FILE* input, FILE* output, const HuffDictionary* dict) {
+    HuffWriter message, packed;
+    if (!huff_writer_open_memory(&message, 4096)) return 0;
+    if (!huff_writer_open_memory(&packed, 4096)) {
+        huff_writer_close(&message);
+        return 0;
+    }
+
+    int ok = huff_dict_read_all(input, &message) && huff_dict_compress(dict, message.data, message.pos, &packed) &&
+             fwrite(packed.data, 1, packed.pos, output) == packed.pos;
+
+    huff_writer_close(&message);
+    huff_writer_close(&packed);
+    return ok;
+}
+
+int decompress_dictionary(FILE* input, FILE* output, const HuffDictionary* dict) {
+    HuffWriter packed, message;
+    rewind(input);
+    if (!huff_writer_open_memory(&packed, 4096)) return 0;
+    if (!huff_writer_open_memory(&message, 4096)) {
+        huff_writer_close(&packed);
+        return 0;
+    }
+
+    int ok = huff_dict_read_all(input, &packed) && huff_dict_decompress(dict, packed.data, packed.pos, &message) &&
+             fwrite(message.data, 1, message.pos, output) == message.pos;
+
+    huff_writer_close(&packed);
+    huff_writer_close(&message);
+    return ok;
+}
+
+#endif // HUFF_DICTIONARY_H
@@ -0,0 +1,116 @@
+/*
+    CONTAGEM DE FREQUÊNCIAS (histograma dos bytes)
+
+    A contagem simples é:  for (...) freq[c]++;
+
+    Exemplo:
+    Quando leio byte 65 ('A'):  freq[65]++  → Incrementa a posição 65 do array
+    Quando leio byte 65 de novo: freq[65]++ → Agora freq[65] = 2
+
+    Problema: em arquivos com o mesmo byte repetido (zeros, espaços...), cada
+    freq[65]++ precisa esperar o freq[65]++ anterior terminar de gravar na memória
+    antes de ler o valor de novo. O processador fica parado nessa dependência.
+
+    Solução: 4 "bancos" de contadores. Bytes seguidos vão para bancos diferentes:
+
+    byte 0 → banco 0,  byte 1 → banco 1,  byte 2 → banco 2,  byte 3 → banco 3,
+    byte 4 → banco 0, ...
+
+    Assim quatro incrementos do mesmo byte podem acontecer ao mesmo tempo. No
+    final somamos os bancos. Em arquivos grandes, cada thread conta um pedaço
+    com seus próprios bancos e os histogramas parciais são somados no final.
+
+    As frequências são uint64_t: com int, arquivos acima de 2 GiB estouravam.
+*/
+
+#ifndef HUFF_HISTOGRAM_H
+#define HUFF_HISTOGRAM_H
+
+#include <stdint.h>
+#include <string.h>
+#include "huff_pool.h"
+
+#define HUFF_HIST_SLICE ((size_t)1 << 30) //contadores dos bancos são uint32_t: somamos no uint64_t a cada 1 GiB
+
+#ifndef HUFF_HIST_PARALLEL_MIN
+#define HUFF_HIST_PARALLEL_MIN (16 * 1024 * 1024) //abaixo de 16 MiB dividir entre threads não compensa
+#endif
+
+// Soma em freq as ocorrências de cada byte de data[0 .. n-1] (freq NÃO é zerado aqui)
+void count_frequencies(const unsigned char* data, size_t n, uint64_t freq[256]) {
+    uint32_t banks[4][256];
+
+    while (n > 0) {
+        size_t slice = n < HUFF_HIST_SLICE ? n : HUFF_HIST_SLICE;
+        size_t i = 0;
+        memset(banks, 0, sizeof(banks));
+
+        //8 bytes por vez: uma leitura de 64 bits, dois bytes para cada banco
+        for (; i + 8 <= slice; i += 8) {
+            uint64_t word;
+            memcpy(&word, data + i, 8);
+
+            banks[0][word & 0xFF]++;
+            banks[1][(word >> 8) & 0xFF]++;
+            banks[2][(word >> 16) & 0xFF]++;
+            banks[3][(word >> 24) & 0xFF]++;
+            banks[0][(word >> 32) & 0xFF]++;
+            banks[1][(word >> 40) & 0xFF]++;
+            banks[2][(word >> 48) & 0xFF]++;
+            banks[3][word >> 56]++;
+        }
+        for (; i < slice; i++) { //os últimos (menos de 8) bytes
+            banks[0][data[i]]++;
+        }
+
+        for (int c = 0; c < 256; c++) {
+            freq[c] += (uint64_t)banks[0][c] + banks[1][c] + banks[2][c] + banks[3][c];
+        }
+
+        data += slice;
+        n -= slice;
+    }
+}
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t parts;
+    uint64_t (*partial)[256]; //um histograma parcial por pedaço
+} HistogramJob;
+
+void histogram_task(void* ctx, size_t index) {
+    HistogramJob* job = ctx;
+    size_t part_size = job->size / job->parts;
+    size_t start = index * part_size;
+    size_t end = (index == job->parts - 1) ? job->size : start + part_size; //o último pega o resto
+
+    count_frequencies(job->data + start, end - start, job->partial[index]);
+}
+
+// Igual count_frequencies, mas divide data entre as threads do pool (pool NULL = uma thread só)
+void count_frequencies_parallel(const unsigned char* data, size_t n, uint64_t freq[256], HuffPool* pool) {
+    if (!pool || pool->thread_count == 1 || n < HUFF_HIST_PARALLEL_MIN) {
+        count_frequencies(data, n, freq);
+        return;
+    }
+
+    HistogramJob job = {data, n, (size_t)pool->thread_count, NULL};
+    job.partial = calloc(job.parts, sizeof(*job.partial));
+    if (!job.partial) {
+        count_frequencies(data, n, freq);
+        return;
+    }
+
+    huff_pool_run(pool, job.parts, histogram_task, &job);
+
+    // Junta os histogramas parciais
+    for (size_t p = 0; p < job.parts; p++) {
+        for (int c = 0; c < 256; c++) {
+            freq[c] += job.partial[p][c];
+        }
+    }
+    free(job.partial);
+}
+
+#endif // HUFF_HISTOGRAM_H
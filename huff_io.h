@@ -0,0 +1,472 @@
+/*
+    ENTRADA E SAÍDA EM BLOCOS
+
+    Ler ou escrever 1 byte por chamada (fread(&c, 1, 1, ...) / fputc) custa uma
+    chamada da libc por byte, com trava do FILE e verificação de erro a cada vez.
+    Aqui os bytes passam por um bloco grande em memória (64 KiB por padrão):
+    o leitor enche o bloco de uma vez (refill) e o escritor só chama fwrite
+    quando o bloco enche (flush).
+
+    Uso típico (leitura):
+
+    HuffReader reader;
+    huff_reader_open(&reader, arquivo, 0);        // 0 = tamanho padrão
+    while (huff_reader_refill(&reader) > 0) {
+        // reader.data[reader.pos .. reader.len-1] são os bytes do bloco
+        reader.pos = reader.len;                   // consumiu o bloco inteiro
+    }
+    huff_reader_close(&reader);
+
+    ARQUIVOS MAPEADOS (mmap)
+
+    Para arquivos locais grandes, huff_reader_open_mapped() mapeia o arquivo
+    inteiro na memória: o "bloco" passa a ser o arquivo todo, sem cópia para
+    buffers do stdio. O mesmo laço acima funciona igual (o primeiro refill
+    entrega o arquivo inteiro, o segundo retorna 0). Pipes, terminais e
+    arquivos pequenos continuam no modo em blocos.
+
+    MEMÓRIA
+
+    huff_reader_open_memory() e huff_writer_open_memory() usam as mesmas
+    estruturas sobre um pedaço de memória: é assim que os blocos do formato
+    em pedaços (huff_chunked.h) são compactados em paralelo, cada thread
+    escrevendo no seu próprio buffer.
+
+    huff_writer_open_fixed() escreve num buffer de quem chama, que nunca é
+    realocado nem liberado: se não couber, o writer marca erro em vez de
+    crescer (huff_buffer.h).
+
+    SAÍDA MAPEADA
+
+    Quando o descompactador já sabe o tamanho final (está no cabeçalho),
+    huff_writer_open_sized() reserva o arquivo de saída inteiro de uma vez
+    (posix_fallocate) e o mapeia: os bytes decodificados vão direto para as
+    páginas do arquivo, sem bloco intermediário e sem fwrite.
+*/
+
+#ifndef HUFF_IO_H
+#define HUFF_IO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "huff_profile.h"
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef HUFF_IO_BLOCK_SIZE
+#define HUFF_IO_BLOCK_SIZE (64 * 1024) //pode ser trocado na compilação: -DHUFF_IO_BLOCK_SIZE=1048576
+#endif
+
+#ifndef HUFF_MMAP_MIN_SIZE
+#define HUFF_MMAP_MIN_SIZE (1024 * 1024) //abaixo de 1 MiB o mmap não compensa o custo de mapear
+#endif
+
+typedef struct {
+    FILE* file;           //arquivo de onde os blocos vêm
+    unsigned char* data;  //bloco atual
+    size_t pos;           //próximo byte ainda não consumido
+    size_t len;           //quantos bytes válidos tem no bloco
+    size_t capacity;      //tamanho do bloco alocado
+    unsigned char* map;   //arquivo inteiro mapeado (NULL no modo em blocos)
+    size_t map_size;      //tamanho do mapeamento
+    size_t map_start;     //de onde a leitura começa dentro do mapeamento
+    int map_delivered;    //1 depois que o refill já entregou o mapeamento
+    int map_owned;        //1 se o mapeamento veio do mmap (precisa de munmap)
+} HuffReader;
+
+typedef struct {
+    FILE* file;           //arquivo para onde os blocos vão (NULL = só memória, o bloco cresce)
+    unsigned char* data;  //bloco sendo preenchido
+    size_t pos;           //quantos bytes já foram colocados no bloco
+    size_t capacity;
+    int error;            //1 se algum fwrite falhou (disco cheio, etc.)
+    int fixed;            //1 = data é de quem chamou: não cresce nem é liberado
+    unsigned char* map;   //saída mapeada (huff_writer_open_sized); NULL nos outros modos
+    size_t map_size;
+} HuffWriter;
+
+int huff_reader_open(HuffReader* reader, FILE* file, size_t block_size) {
+    if (block_size == 0) block_size = HUFF_IO_BLOCK_SIZE;
+
+    reader->file = file;
+    reader->data = malloc(block_size);
+    reader->pos = 0;
+    reader->len = 0;
+    reader->capacity = block_size;
+    reader->map = NULL;
+    reader->map_size = 0;
+    reader->map_start = 0;
+    reader->map_delivered = 0;
+    reader->map_owned = 0;
+
+    if (!reader->data) {
+        perror("Erro ao alocar bloco de leitura");
+        return 0;
+    }
+    return 1;
+}
+
+// Descarta o que sobrou do bloco atual e lê o próximo. Retorna quantos bytes vieram (0 = fim do arquivo)
+size_t huff_reader_refill(HuffReader* reader) {
+    if (reader->map) { //modo mapeado: um único "bloco" com o arquivo inteiro
+        reader->pos = 0;
+        reader->len = 0;
+        if (!reader->map_delivered) {
+            reader->data = reader->map + reader->map_start;
+            reader->len = reader->map_size - reader->map_start;
+            reader->map_delivered = 1;
+        }
+        return reader->len;
+    }
+
+    HUFF_PROFILE_BEGIN(profile);
+    reader->pos = 0;
+    reader->len = fread(reader->data, 1, reader->capacity, reader->file);
+    HUFF_PROFILE_END(profile, HUFF_STAGE_IO_READ, reader->len);
+    return reader->len;
+}
+
+// Equivalente ao fgetc, mas só chama a libc quando o bloco acaba
+static inline int huff_read_byte(HuffReader* reader) {
+    if (reader->pos == reader->len && huff_reader_refill(reader) == 0) return EOF;
+    return reader->data[reader->pos++];
+}
+
+// Volta para o início do arquivo (segunda passada da compactação)
+void huff_reader_rewind(HuffReader* reader) {
+    if (reader->map) {
+        reader->map_start = 0;
+        reader->map_delivered = 0;
+        reader->pos = 0;
+        reader->len = 0;
+        return;
+    }
+
+    rewind(reader->file);
+    reader->pos = 0;
+    reader->len = 0;
+}
+
+void huff_reader_close(HuffReader* reader) {
+    if (reader->map) {
+#ifndef _WIN32
+        if (reader->map_owned) munmap(reader->map, reader->map_size);
+#endif
+        reader->map = NULL;
+        reader->data = NULL;
+    }
+    free(reader->data);
+    reader->data = NULL;
+    reader->pos = reader->len = reader->capacity = 0;
+}
+
+/*Posição no arquivo em 64 bits. ftell/fseek usam long, que tem 32 bits no Windows
+e em sistemas de 32 bits: lá, arquivos acima de 2 GiB davam posições negativas.
+(Em Linux de 32 bits, compile com -D_FILE_OFFSET_BITS=64 para o off_t ter 64 bits.)*/
+int huff_seek(FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+// Retorna -1 se der erro
+int64_t huff_tell(FILE* file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (int64_t)ftello(file);
+#endif
+}
+
+// Tamanho do arquivo inteiro em *size, voltando para a posição em que estava. Retorna 0 se não der (pipe...)
+int huff_file_size(FILE* file, uint64_t* size) {
+    int64_t here = huff_tell(file);
+    if (here < 0) return 0;
+#ifdef _WIN32
+    int ok = _fseeki64(file, 0, SEEK_END) == 0;
+#else
+    int ok = fseeko(file, 0, SEEK_END) == 0;
+#endif
+    int64_t end = ok ? huff_tell(file) : -1;
+    if (!huff_seek(file, (uint64_t)here) || end < 0) return 0;
+    *size = (uint64_t)end;
+    return 1;
+}
+
+/*Tenta mapear o arquivo inteiro; a leitura começa na posição atual do FILE
+(assim o descompactador pode pular o cabeçalho com fseek antes de abrir).
+Se não for um arquivo comum, for pequeno ou o mmap falhar, cai no modo em blocos.*/
+int huff_reader_open_mapped(HuffReader* reader, FILE* file) {
+#ifndef _WIN32
+    struct stat st;
+    int64_t start = huff_tell(file);
+
+    if (start >= 0 && fstat(fileno(file), &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= HUFF_MMAP_MIN_SIZE
+            && (uint64_t)st.st_size <= SIZE_MAX && (uint64_t)start <= (uint64_t)st.st_size) {
+        void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+        if (map != MAP_FAILED) {
+            madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL); //avisa o kernel: leitura do início ao fim, pode ler adiantado
+
+            reader->file = file;
+            reader->data = NULL;
+            reader->pos = 0;
+            reader->len = 0;
+            reader->capacity = 0;
+            reader->map = map;
+            reader->map_size = (size_t)st.st_size;
+            reader->map_start = (size_t)start;
+            reader->map_delivered = 0;
+            reader->map_owned = 1;
+            return 1;
+        }
+    }
+#endif
+    return huff_reader_open(reader, file, 0); //pipe, arquivo pequeno ou sistema sem mmap
+}
+
+// Lê direto de um pedaço de memória que já existe (nada é copiado nem alocado)
+void huff_reader_open_memory(HuffReader* reader, const unsigned char* data, size_t size) {
+    reader->file = NULL;
+    reader->data = NULL;
+    reader->pos = 0;
+    reader->len = 0;
+    reader->capacity = 0;
+    reader->map = (unsigned char*)data; //só leitura: nunca escrevemos em map
+    reader->map_size = size;
+    reader->map_start = 0;
+    reader->map_delivered = 0;
+    reader->map_owned = 0;
+}
+
+/*Entrega os próximos n bytes (ou menos, no fim do arquivo) em *out.
+Mapeado/memória: *out aponta direto para os dados, sem cópia.
+Em blocos: os bytes são copiados para scratch (que precisa ter n bytes).
+Retorna quantos bytes foram entregues.*/
+size_t huff_reader_take(HuffReader* reader, size_t n, unsigned char* scratch, const unsigned char** out) {
+    if (reader->map) {
+        if (reader->pos == reader->len && huff_reader_refill(reader) == 0) {
+            *out = NULL;
+            return 0;
+        }
+        size_t avail = reader->len - reader->pos;
+        size_t take = n < avail ? n : avail;
+        *out = reader->data + reader->pos;
+        reader->pos += take;
+        return take;
+    }
+
+    size_t got = 0;
+    while (got < n) {
+        if (reader->pos == reader->len && huff_reader_refill(reader) == 0) break;
+
+        size_t avail = reader->len - reader->pos;
+        size_t chunk = (n - got) < avail ? (n - got) : avail;
+        memcpy(scratch + got, reader->data + reader->pos, chunk);
+        reader->pos += chunk;
+        got += chunk;
+    }
+    *out = scratch;
+    return got;
+}
+
+int huff_writer_open(HuffWriter* writer, FILE* file, size_t block_size) {
+    if (block_size == 0) block_size = HUFF_IO_BLOCK_SIZE;
+
+    writer->file = file;
+    writer->data = malloc(block_size);
+    writer->pos = 0;
+    writer->capacity = block_size;
+    writer->error = 0;
+    writer->fixed = 0;
+    writer->map = NULL;
+    writer->map_size = 0;
+
+    if (!writer->data) {
+        perror("Erro ao alocar bloco de escrita");
+        return 0;
+    }
+    return 1;
+}
+
+// Escreve só em memória: o bloco começa com initial_capacity bytes e dobra quando enche
+int huff_writer_open_memory(HuffWriter* writer, size_t initial_capacity) {
+    return huff_writer_open(writer, NULL, initial_capacity);
+}
+
+// Escreve nos capacity bytes de buffer (nada é alocado). Passar do fim marca erro
+void huff_writer_open_fixed(HuffWriter* writer, unsigned char* buffer, size_t capacity) {
+    writer->file = NULL;
+    writer->data = buffer;
+    writer->pos = 0;
+    writer->capacity = capacity;
+    writer->error = 0;
+    writer->fixed = 1;
+    writer->map = NULL;
+    writer->map_size = 0;
+}
+
+/*Para quem vai escrever exatamente size bytes em file, a partir da posição atual
+(o descompactador, com o tamanho original do cabeçalho).
+Arquivo comum de pelo menos HUFF_MMAP_MIN_SIZE bytes: o arquivo é aumentado para o
+tamanho final com posix_fallocate e mapeado. writer->data aponta para dentro do
+arquivo, e passar de size bytes marca erro (igual a huff_writer_open_fixed).
+Só mapeamos com os blocos reservados: escrever num mapeamento sem espaço no disco
+mata o programa (SIGBUS) em vez de dar erro no fwrite.
+Nos outros casos (pipe, arquivo pequeno, aberto só para escrita, sem posix_fallocate)
+é igual a huff_writer_open(file, 0).*/
+int huff_writer_open_sized(HuffWriter* writer, FILE* file, uint64_t size) {
+#ifdef __linux__
+    struct stat st;
+    int fd = fileno(file);
+    int64_t start = fflush(file) == 0 ? huff_tell(file) : -1;
+
+    //mapear para escrita exige o arquivo aberto para leitura também ("w+b"): com "wb" fica no caminho comum
+    if (start >= 0 && size >= HUFF_MMAP_MIN_SIZE && size <= SIZE_MAX - (uint64_t)start
+            && (fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDWR && fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size_t map_size = (size_t)start + (size_t)size;
+        void* map = MAP_FAILED;
+        if (posix_fallocate(fd, (off_t)start, (off_t)size) == 0) {
+            map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        if (map != MAP_FAILED) {
+            madvise(map, map_size, MADV_SEQUENTIAL);
+            huff_writer_open_fixed(writer, (unsigned char*)map + start, (size_t)size);
+            writer->file = file;
+            writer->map = map;
+            writer->map_size = map_size;
+            return 1;
+        }
+        //posix_fallocate pode falhar no meio (ENOSPC) e deixar o que já reservou: desfaz sempre antes do caminho comum
+        if (ftruncate(fd, (off_t)start) != 0) return 0;
+    }
+#endif
+    return huff_writer_open(writer, file, 0);
+}
+
+/*Em memória: garante espaço para pelo menos size bytes no bloco (só aumenta, nunca diminui).
+Quem reaproveita o mesmo writer (huff_ctx.h) chama uma vez com o tamanho esperado
+e o bloco não precisa dobrar várias vezes. Retorna 0 se faltar memória.*/
+int huff_writer_reserve(HuffWriter* writer, size_t size) {
+    if (writer->file || size <= writer->capacity) return 1;
+    if (writer->fixed) return 0;
+
+    unsigned char* bigger = realloc(writer->data, size);
+    if (!bigger) {
+        perror("Erro ao aumentar bloco de escrita");
+        return 0;
+    }
+    writer->data = bigger;
+    writer->capacity = size;
+    return 1;
+}
+
+// Manda para o arquivo tudo que está no bloco e esvazia o bloco (em memória: aumenta o bloco)
+void huff_writer_flush(HuffWriter* writer) {
+    if (!writer->file || writer->fixed) {
+        if (writer->pos < writer->capacity) return;
+        if (writer->error || writer->fixed) {
+            writer->error = 1;
+            writer->pos = 0; //descarta para não escrever fora do bloco; o erro já foi marcado
+            return;
+        }
+
+        size_t new_capacity = writer->capacity * 2;
+        unsigned char* bigger = realloc(writer->data, new_capacity);
+        if (!bigger) {
+            writer->error = 1;
+            writer->pos = 0; //descarta para não escrever fora do bloco; o erro já foi marcado
+            return;
+        }
+        writer->data = bigger;
+        writer->capacity = new_capacity;
+        return;
+    }
+
+    if (writer->pos == 0) return;
+
+    HUFF_PROFILE_BEGIN(profile);
+    if (fwrite(writer->data, 1, writer->pos, writer->file) != writer->pos) {
+        writer->error = 1;
+    }
+    HUFF_PROFILE_END(profile, HUFF_STAGE_IO_WRITE, writer->pos);
+    writer->pos = 0;
+}
+
+// Equivalente ao fputc
+static inline void huff_write_byte(HuffWriter* writer, unsigned char byte) {
+    if (writer->pos == writer->capacity) huff_writer_flush(writer);
+    writer->data[writer->pos++] = byte;
+}
+
+// Equivalente ao fwrite: copia pedaços grandes direto, sem passar byte a byte
+void huff_write_bytes(HuffWriter* writer, const unsigned char* bytes, size_t n) {
+    while (n > 0) {
+        if (writer->pos == writer->capacity) huff_writer_flush(writer);
+
+        size_t room = writer->capacity - writer->pos;
+        size_t chunk = n < room ? n : room;
+        memcpy(writer->data + writer->pos, bytes, chunk);
+        writer->pos += chunk;
+        bytes += chunk;
+        n -= chunk;
+    }
+}
+
+// Inteiros de tamanho fixo nos cabeçalhos, sempre little-endian (byte menos significativo primeiro)
+void huff_write_u32(HuffWriter* writer, uint32_t value) {
+    for (int i = 0; i < 4; i++) huff_write_byte(writer, (unsigned char)(value >> (8 * i)));
+}
+
+void huff_write_u64(HuffWriter* writer, uint64_t value) {
+    for (int i = 0; i < 8; i++) huff_write_byte(writer, (unsigned char)(value >> (8 * i)));
+}
+
+uint32_t huff_get_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Grava value em p[0..3] (little-endian): para preencher depois um campo já escrito em memória
+void huff_set_u32(unsigned char* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) p[i] = (unsigned char)(value >> (8 * i));
+}
+
+uint64_t huff_get_u64(const unsigned char* p) {
+    return (uint64_t)huff_get_u32(p) | ((uint64_t)huff_get_u32(p + 4) << 32);
+}
+
+// Faz o flush final e libera o bloco. Retorna 0 se alguma escrita falhou
+int huff_writer_close(HuffWriter* writer) {
+#ifdef __linux__
+    if (writer->map) {
+        //os bytes já estão no arquivo (MAP_SHARED): só desmapeia e ajusta o FILE*
+        uint64_t end = (uint64_t)(writer->data - writer->map) + writer->pos;
+        munmap(writer->map, writer->map_size);
+        writer->map = NULL;
+        writer->data = NULL;
+        //escreveu menos que o reservado (arquivo corrompido): corta os zeros que sobraram
+        if (writer->pos < writer->capacity && ftruncate(fileno(writer->file), (off_t)end) != 0) writer->error = 1;
+        if (!huff_seek(writer->file, end)) writer->error = 1;
+        writer->pos = writer->capacity = 0;
+        return !writer->error;
+    }
+#endif
+    if (writer->file) huff_writer_flush(writer);
+    if (!writer->fixed) free(writer->data);
+    writer->data = NULL;
+    writer->pos = writer->capacity = 0;
+    return !writer->error;
+}
+
+#endif // HUFF_IO_H
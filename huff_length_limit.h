@@ -0,0 +1,165 @@
+/*
+    CÓDIGOS COM COMPRIMENTO LIMITADO (package-merge)
+
+    A árvore de Huffman comum não tem limite de profundidade. Com frequências
+    tipo Fibonacci (1, 1, 2, 3, 5, 8, ...) cada byte novo desce um nível:
+    40 bytes diferentes já dão códigos de 39 bits, que não cabem no uint32_t
+    de HuffmanCode e estragavam o arquivo sem aviso.
+
+    O package-merge acha os comprimentos ÓTIMOS com a restrição
+    "nenhum código maior que max_bits". Ideia (problema das moedas):
+
+    - cada byte vira uma "moeda" de valor = frequência, em cada um dos níveis 1..max_bits;
+    - do nível mais fundo para o mais raso: junta as moedas do nível de baixo de
+      duas em duas (pacotes, valor = soma) e mistura com as moedas originais,
+      em ordem de valor;
+    - no nível 1, pega as 2n - 2 mais baratas. O comprimento de cada byte é
+      quantas vezes ele aparece nas escolhas (dentro dos pacotes também).
+
+    Exemplo: A=1 B=1 C=2 D=4, max_bits = 2
+    nível 2: A1 B1 C2 D4
+    nível 1: A1 B1 C2 (AB)2 D4 (CD)6     ← pacotes do nível 2: (AB)=2, (CD)=6
+    escolhe as 2*4-2 = 6 primeiras: 2 pacotes → abre A, B, C, D no nível 2 → cada byte aparece 2 vezes
+    resultado: todos com 2 bits (sem limite seria A=3 B=3 C=2 D=1)
+
+    Custo: O(n * max_bits) com n <= 256, desprezível perto de contar as frequências.
+*/
+
+#ifndef HUFF_LENGTH_LIMIT_H
+#define HUFF_LENGTH_LIMIT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef HUFF_MAX_CODE_LENGTH
+#define HUFF_MAX_CODE_LENGTH 15 //mantém os códigos longos raros e a busca lenta curta; 12 deixa tudo perto da janela da tabela
+#endif
+
+typedef struct {
+    uint64_t weight;
+    int16_t symbol; //byte da moeda original, -1 = pacote
+} HuffCoin;
+
+/*Ordena as moedas por valor (crescente, estável) com radix sort: 8 passadas de
+contagem, uma por byte do uint64_t. Passadas em que todas as moedas têm o
+mesmo byte (os bytes altos, quase sempre zero) são puladas.*/
+void huff_sort_coins(HuffCoin* coins, int n) {
+    if (n < 32) { //poucas moedas: zerar 8 contadores de 256 custa mais que o insertion sort
+        for (int i = 1; i < n; i++) {
+            HuffCoin coin = coins[i];
+            int j = i - 1;
+            while (j >= 0 && coins[j].weight > coin.weight) {
+                coins[j + 1] = coins[j];
+                j--;
+            }
+            coins[j + 1] = coin;
+        }
+        return;
+    }
+
+    HuffCoin buffer[256];
+    HuffCoin* from = coins;
+    HuffCoin* to = buffer;
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        int count[256] = {0};
+        for (int i = 0; i < n; i++) count[(from[i].weight >> shift) & 0xFF]++;
+        if (n == 0 || count[(from[0].weight >> shift) & 0xFF] == n) continue; //todos iguais nesse byte
+
+        int start = 0; //onde cada valor do byte começa na saída
+        for (int d = 0; d < 256; d++) {
+            int c = count[d];
+            count[d] = start;
+            start += c;
+        }
+        for (int i = 0; i < n; i++) to[count[(from[i].weight >> shift) & 0xFF]++] = from[i];
+
+        HuffCoin* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != coins) memcpy(coins, from, sizeof(HuffCoin) * (size_t)n);
+}
+
+/*Calcula em lengths[] os comprimentos ótimos com no máximo max_bits bits (bytes ausentes = 0).
+Um byte sozinho recebe 1 bit. max_bits é ajustado para caber todos os bytes (2^max_bits >= n)
+e para no máximo 32. Retorna 0 se faltou memória.*/
+int huff_limited_code_lengths(const uint64_t freq[256], int max_bits, unsigned char lengths[256]) {
+    HuffCoin leaves[256];
+    int n = 0;
+
+    for (int s = 0; s < 256; s++) {
+        lengths[s] = 0;
+        if (freq[s] > 0) {
+            leaves[n].weight = freq[s];
+            leaves[n].symbol = (int16_t)s;
+            n++;
+        }
+    }
+    if (n == 0) return 1;
+    if (n == 1) {
+        lengths[leaves[0].symbol] = 1;
+        return 1;
+    }
+
+    if (max_bits > 32) max_bits = 32;
+    while ((1 << max_bits) < n) max_bits++;
+
+    huff_sort_coins(leaves, n); //moedas originais em ordem crescente de valor
+
+    // levels[l] = moedas do nível l+1, em ordem; cada nível tem no máximo 2n - 1 moedas
+    HuffCoin* levels = malloc(sizeof(HuffCoin) * (size_t)max_bits * (2 * n));
+    int* sizes = malloc(sizeof(int) * (size_t)max_bits);
+    if (!levels || !sizes) {
+        free(levels);
+        free(sizes);
+        return 0;
+    }
+
+    // 1. Nível mais fundo: só as moedas originais
+    HuffCoin* deepest = levels + (size_t)(max_bits - 1) * (2 * n);
+    for (int i = 0; i < n; i++) deepest[i] = leaves[i];
+    sizes[max_bits - 1] = n;
+
+    // 2. Subindo: pacotes do nível de baixo misturados com as moedas originais
+    for (int l = max_bits - 2; l >= 0; l--) {
+        HuffCoin* below = levels + (size_t)(l + 1) * (2 * n);
+        HuffCoin* level = levels + (size_t)l * (2 * n);
+        int packages = sizes[l + 1] / 2;
+        int i = 0, p = 0, size = 0;
+
+        while (i < n || p < packages) {
+            uint64_t package_weight = p < packages ? below[2 * p].weight + below[2 * p + 1].weight : 0;
+
+            if (p == packages || (i < n && leaves[i].weight <= package_weight)) {
+                level[size++] = leaves[i++];
+            } else {
+                level[size].weight = package_weight;
+                level[size].symbol = -1;
+                size++;
+                p++;
+            }
+        }
+        sizes[l] = size;
+    }
+
+    // 3. Escolhe 2n - 2 moedas no nível 1 e desce abrindo os pacotes escolhidos
+    int take = 2 * n - 2;
+    for (int l = 0; l < max_bits && take > 0; l++) {
+        HuffCoin* level = levels + (size_t)l * (2 * n);
+        int packages = 0;
+
+        for (int i = 0; i < take; i++) {
+            if (level[i].symbol >= 0) lengths[level[i].symbol]++;
+            else packages++;
+        }
+        take = 2 * packages; //cada pacote escolhido = as 2 primeiras moedas ainda não usadas do nível de baixo
+    }
+
+    free(levels);
+    free(sizes);
+    return 1;
+}
+
+#endif // HUFF_LENGTH_LIMIT_H
@@ -0,0 +1,715 @@
+/*
+    LZ77 + HUFFMAN (repetições antes da entropia)
+
+    O Huffman sozinho só aproveita que alguns bytes são mais comuns que
+    outros. Em logs, CSV e regiões zeradas o que mais se repete são TRECHOS
+    inteiros: a mesma linha de cabeçalho, o mesmo timestamp até os segundos,
+    4 KB de zeros. O LZ77 troca cada trecho repetido por um par
+    (comprimento, distância) = "copie comprimento bytes que estão distância
+    bytes para trás". O arquivo vira uma série de SEQUÊNCIAS:
+
+        [quantos literais][os literais (bytes avulsos)][uma cópia]
+
+    e cada tipo de número vai para o Huffman com a sua própria tabela:
+
+    - literais:     os bytes avulsos (0..255);
+    - sequências:   quantos literais vêm antes da cópia;
+    - comprimentos: tamanho da cópia;
+    - distâncias:   quantos bytes para trás.
+
+    (Um código de Huffman gasta pelo menos 1 bit: marcar cada literal com
+    um "vem literal" custaria 1 bit a mais por byte. Contando os literais
+    de uma vez, o custo é um número por sequência.)
+
+    Comprimento e distância usam faixas (como no DEFLATE): o código de
+    Huffman diz a faixa e alguns bits extras dizem o valor exato dentro dela.
+
+        valor v         faixa               bits extras
+        0 .. 15         v                   0             (sequências e comprimentos)
+        16 ..           12 + bits(v)        bits(v) - 1
+        0 .. 3          v                   0             (distâncias)
+        4 ..            1 + bits(v)         bits(v) - 1
+
+    Exemplo: "abcabcabcX"
+    [3][a b c][cópia de 6, distância 3]   (a cópia começa dentro dela mesma)
+    [1][X]                                (o bloco acabou: sequência sem cópia)
+
+    BUSCA DAS REPETIÇÕES (nível 0 a 9)
+
+    Os 4 bytes a partir de cada posição viram um hash; head[hash] guarda a
+    última posição com esse hash e prev[] encadeia as anteriores (a "hash
+    chain"). Quanto maior o nível, mais posições da corrente são testadas:
+
+    nível 0:  só RLE (cópias a distância 1: sequências do mesmo byte), sem hash
+    nível 1:  4 candidatos por posição, não indexa o meio das cópias
+    nível 5:  32 candidatos + "lazy matching" (olha se a próxima posição rende mais)
+    nível 9:  1024 candidatos
+
+    Cada candidato é um acesso a um ponto qualquer da janela de 1 MiB (quase
+    sempre fora do cache), então a busca para cedo quando a cópia já está
+    boa: "good" corta os candidatos restantes para 1/4 e "nice" para de vez
+    (ver lz_levels).
+
+    Uma cópia curta e distante pode sair mais cara que os literais que ela
+    troca: 4 bytes a 500 KiB para trás custam a faixa do comprimento, a da
+    distância e 18 bits extras, quase 30 bits, e em dados de 4 bits por byte
+    os literais custariam 16. Antes de aceitar uma cópia, o custo estimado
+    dela é comparado com o dos literais (lz_match_pays): os literais pelo
+    Huffman dos bytes do próprio bloco, as faixas pelas tabelas do bloco
+    anterior.
+
+    Layout do arquivo (inteiros em little-endian):
+
+    [4 bytes]   "HUFL"
+    [1 byte]    versão
+    [1 byte]    nível usado (só informativo)
+    [1 byte]    bits da janela (0 = 20, arquivos anteriores a esse campo)
+    [1 byte]    zerado
+    [8 bytes]   tamanho original (u64)
+    [blocos]    u32 bytes originais do bloco | u32 bytes de bits
+                | comprimentos: literais, sequências, comprimentos, distâncias (write_code_lengths)
+                | bits (o último byte completado com zeros)
+
+    Cada bloco (HUFF_LZ_BLOCK_SIZE bytes da entrada) tem as suas quatro
+    tabelas, mas as cópias podem apontar para blocos anteriores (até
+    HUFF_LZ_WINDOW bytes para trás). Por isso o compactador tem o arquivo
+    original inteiro na memória (mapeado, quando possível); o descompactador
+    decodifica direto na saída mapeada ou guarda só a última janela.
+*/
+
+#ifndef HUFF_LZ_H
+#define HUFF_LZ_H
+
+#include "huffman.h"
+
+#define HUFF_LZ_VERSION 1
+#define HUFF_LZ_HEADER_SIZE 16
+#define HUFF_LZ_MIN_MATCH 4                         //menor cópia do formato (se compensa os literais, lz_match_pays decide)
+#define HUFF_LZ_MAX_MATCH (HUFF_LZ_MIN_MATCH + 65535)
+#ifndef HUFF_LZ_HASH_BITS
+#define HUFF_LZ_HASH_BITS 20 //tantas entradas quanto a janela: com menos, dados sem repetição enchem as correntes de candidatos inúteis
+#endif
+
+#ifndef HUFF_LZ_WINDOW_BITS
+#define HUFF_LZ_WINDOW_BITS 20 //cópias de até 1 MiB para trás
+#endif
+#define HUFF_LZ_WINDOW (1 << HUFF_LZ_WINDOW_BITS)
+
+/*Quantos bytes da saída um byte de bits gera, no máximo: cada sequência gasta
+pelo menos 1 bit em cada tabela, e a maior cópia (HUFF_LZ_MAX_MATCH bytes) ainda
+leva 15 bits extras no comprimento: 65539 bytes em 18 bits, menos de 3642 por bit.*/
+#define HUFF_LZ_MAX_EXPANSION (8 * 3642)
+
+#ifndef HUFF_LZ_BLOCK_SIZE
+#define HUFF_LZ_BLOCK_SIZE (256 * 1024) //bytes da entrada por bloco (cada bloco tem as suas tabelas)
+#endif
+
+#ifndef HUFF_LZ_SKIP_AFTER
+#define HUFF_LZ_SKIP_AFTER 64 //literais seguidos até a busca começar a pular posições
+#endif
+
+#ifndef HUFF_LZ_DEFAULT_LEVEL
+#define HUFF_LZ_DEFAULT_LEVEL 5
+#endif
+
+// Quantos bits são necessários para escrever v (bits(0) = 0)
+static inline int lz_bit_length(uint32_t v) {
+    int bits = 0;
+    while (v) {
+        bits++;
+        v >>= 1;
+    }
+    return bits;
+}
+
+// Valor → faixa (símbolo da tabela) + bits extras. small = até onde o valor é o próprio símbolo
+static inline void lz_bucket(uint32_t v, uint32_t small, int offset, int* symbol, uint32_t* extra, int* extra_bits) {
+    if (v < small) {
+        *symbol = (int)v;
+        *extra = 0;
+        *extra_bits = 0;
+        return;
+    }
+    int bits = lz_bit_length(v);
+    *symbol = offset + bits;
+    *extra_bits = bits - 1;
+    *extra = v & ((1u << (bits - 1)) - 1); //o bit mais alto está implícito na faixa
+}
+
+// Faixa + bits extras → valor (inverso de lz_bucket)
+static inline uint32_t lz_unbucket(int symbol, uint32_t small, int offset, uint32_t extra) {
+    if ((uint32_t)symbol < small) return (uint32_t)symbol;
+    int bits = symbol - offset;
+    return (1u << (bits - 1)) | extra;
+}
+
+#define LZ_LENGTH_SMALL 16
+#define LZ_LENGTH_OFFSET 12
+#define LZ_DISTANCE_SMALL 4
+#define LZ_DISTANCE_OFFSET 1
+
+static inline int lz_extra_bits(int symbol, uint32_t small, int offset) {
+    return (uint32_t)symbol < small ? 0 : symbol - offset - 1;
+}
+
+/*Estado da busca: hash chains sobre o arquivo inteiro.
+As posições são guardadas como posição + 1 em 32 bits (0 = vazio): metade da
+memória de 64 bits, mais correntes cabem no cache. Em arquivos de mais de 4 GB
+o número "dá a volta", mas a distância (sempre < janela) continua certa, e
+toda cópia é conferida byte a byte antes de ser usada.*/
+typedef struct {
+    const unsigned char* data;
+    uint64_t size;
+    uint32_t head[1 << HUFF_LZ_HASH_BITS]; //última posição com cada hash
+    uint32_t* prev;                         //posição anterior com o mesmo hash (índice = posição % janela)
+    int chain;                              //quantos candidatos testar por posição
+    uint32_t good;                          //cópia boa: testa só 1/4 dos candidatos que faltam
+    uint32_t nice;                          //cópia "boa o bastante": para de procurar e não tenta o lazy
+    int lazy;
+    int level;
+    unsigned char literal_bits[256];  //custo estimado de cada byte como literal (bits do código)
+    unsigned char run_bits[256];      //custo estimado de cada faixa de sequência / comprimento / distância
+    unsigned char length_bits[256];
+    unsigned char distance_bits[256];
+} LzMatcher;
+
+static inline uint32_t lz_hash(const unsigned char* p) {
+    uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    return (v * 2654435761u) >> (32 - HUFF_LZ_HASH_BITS);
+}
+
+static inline void lz_insert(LzMatcher* m, uint64_t pos) {
+    if (m->level == 0 || pos + HUFF_LZ_MIN_MATCH > m->size) return;
+    uint32_t h = lz_hash(m->data + pos);
+    m->prev[pos & (HUFF_LZ_WINDOW - 1)] = m->head[h];
+    m->head[h] = (uint32_t)(pos + 1);
+}
+
+// Maior cópia que começa em pos. Retorna o comprimento (0 = nenhuma) e a distância em *distance
+static uint32_t lz_find(const LzMatcher* m, uint64_t pos, uint32_t* distance) {
+    uint64_t left = m->size - pos;
+    uint32_t limit = left < HUFF_LZ_MAX_MATCH ? (uint32_t)left : HUFF_LZ_MAX_MATCH;
+    if (limit < HUFF_LZ_MIN_MATCH) return 0;
+
+    const unsigned char* current = m->data + pos;
+    uint32_t best = 0;
+
+    if (m->level == 0) { //RLE: só o byte anterior se repetindo
+        if (pos == 0) return 0;
+        uint32_t len = 0;
+        while (len < limit && current[len] == current[-1]) len++;
+        *distance = 1;
+        return len >= HUFF_LZ_MIN_MATCH ? len : 0;
+    }
+
+    uint32_t stored = m->head[lz_hash(current)];
+    for (int tries = m->chain; stored != 0 && tries > 0; tries--) {
+        uint32_t dist = (uint32_t)(pos + 1) - stored;
+        if (dist == 0 || dist >= HUFF_LZ_WINDOW || dist > pos) break; //a corrente só fica mais longe daqui para frente
+
+        uint64_t candidate = pos - dist;
+        const unsigned char* past = m->data + candidate;
+        if (past[best] == current[best]) { //teste rápido: só vale a pena se pode superar a melhor
+            uint32_t len = 0;
+            while (len < limit && past[len] == current[len]) len++;
+            if (len > best) {
+                if (best < m->good && len >= m->good) tries >>= 2;
+                best = len;
+                *distance = dist;
+                if (len >= m->nice || len == limit) break;
+            }
+        }
+        stored = m->prev[candidate & (HUFF_LZ_WINDOW - 1)];
+    }
+    return best >= HUFF_LZ_MIN_MATCH ? best : 0;
+}
+
+/*Custo estimado de uma cópia em bits: o código de cada faixa + os bits extras. Cada
+cópia fecha uma sequência, então entra também o número de literais antes dela (run):
+sem a cópia, esses literais iriam junto com os seguintes, num número só.*/
+static inline uint32_t lz_match_bits(const LzMatcher* m, uint32_t run, uint32_t len, uint32_t distance) {
+    int symbol, extra_bits;
+    uint32_t extra, bits;
+    lz_bucket(run, LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET, &symbol, &extra, &extra_bits);
+    bits = m->run_bits[symbol] + (uint32_t)extra_bits;
+    lz_bucket(len - HUFF_LZ_MIN_MATCH, LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET, &symbol, &extra, &extra_bits);
+    bits += m->length_bits[symbol] + (uint32_t)extra_bits;
+    lz_bucket(distance - 1, LZ_DISTANCE_SMALL, LZ_DISTANCE_OFFSET, &symbol, &extra, &extra_bits);
+    return bits + m->distance_bits[symbol] + (uint32_t)extra_bits;
+}
+
+// A cópia em pos (depois de run literais) sai mais barata que os len literais que ela substitui?
+static int lz_match_pays(const LzMatcher* m, uint64_t pos, uint32_t run, uint32_t len, uint32_t distance) {
+    uint32_t cost = lz_match_bits(m, run, len, distance);
+    uint32_t literals = 0;
+    for (uint32_t i = 0; i < len; i++) { //para assim que os literais passam da cópia: cópias longas saem logo
+        literals += m->literal_bits[m->data[pos + i]];
+        if (literals > cost) return 1;
+    }
+    return 0;
+}
+
+// Custo de cada literal no bloco data[start .. end): o código de Huffman dos bytes do bloco
+static void lz_estimate_literals(LzMatcher* m, uint64_t start, uint64_t end) {
+    uint64_t freq[256] = {0};
+    for (uint64_t p = start; p < end; p++) freq[m->data[p]]++;
+    if (!huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, m->literal_bits)) {
+        memset(m->literal_bits, 8, sizeof(m->literal_bits)); //sem estimativa: 8 bits por byte
+    }
+}
+
+/*Custo de cada faixa para o próximo bloco: o comprimento do código dela no bloco que
+acabou. Faixa que não apareceu ganha um bit a mais que o maior código; sem nenhuma
+faixa (bloco só de literais, ou o primeiro bloco), 5 bits para todas (~30 faixas).*/
+static void lz_set_bits(unsigned char bits[256], const unsigned char* lengths) {
+    int longest = 0;
+    for (int s = 0; lengths && s < 256; s++) {
+        if (lengths[s] > longest) longest = lengths[s];
+    }
+    for (int s = 0; s < 256; s++) {
+        bits[s] = (unsigned char)(longest == 0 ? 5 : lengths[s] ? lengths[s] : longest + 1);
+    }
+}
+
+// Parâmetros de cada nível (como a configuration_table do zlib)
+static const struct {
+    int chain;      //candidatos por posição
+    uint32_t good;  //a partir daqui, só 1/4 dos candidatos restantes
+    uint32_t nice;  //a partir daqui, para de procurar
+    int lazy;
+} lz_levels[10] = {
+    {0, 0, 0, 0},          //0: só RLE
+    {4, 8, 16, 0},
+    {8, 8, 32, 0},
+    {16, 16, 64, 0},
+    {16, 16, 64, 1},
+    {32, 32, 128, 1},
+    {64, 32, 258, 1},
+    {128, 64, 512, 1},
+    {256, 128, 1024, 1},
+    {1024, 258, 4096, 1},
+};
+
+// Um bloco já separado em tokens: length[i] = 0 → literal[i]; senão cópia (length[i], distance[i])
+typedef struct {
+    uint32_t* length;
+    uint32_t* distance;
+    unsigned char* literal;
+    size_t count;
+} LzTokens;
+
+// Separa data[start .. end) em literais e cópias
+static void lz_parse_block(LzMatcher* m, uint64_t start, uint64_t end, LzTokens* tokens) {
+    tokens->count = 0;
+    uint64_t pos = start;
+    uint32_t len = 0, distance = 0;
+    int known = 0; //1 = len/distance de pos já foram calculados pelo lazy da posição anterior
+    uint32_t run = 0; //literais desde a última cópia
+
+    while (pos < end) {
+        //trecho longo sem cópia que compense (dados aleatórios, enviesados): procura só a cada 4 posições
+        if (!known) len = run < HUFF_LZ_SKIP_AFTER || (run & 3) == 0 ? lz_find(m, pos, &distance) : 0;
+        known = 0;
+        if (len > end - pos) len = (uint32_t)(end - pos); //a cópia não atravessa o fim do bloco
+        if (len < HUFF_LZ_MIN_MATCH || !lz_match_pays(m, pos, run, len, distance)) len = 0;
+        lz_insert(m, pos);
+
+        if (len && len < m->nice && m->lazy && pos + 1 < end) { //a próxima posição rende uma cópia maior? então esta vira literal
+            uint32_t next_distance;
+            uint32_t next = lz_find(m, pos + 1, &next_distance);
+            if (next > len + 1 && lz_match_pays(m, pos + 1, run + 1, next, next_distance)) {
+                run++;
+                tokens->length[tokens->count] = 0;
+                tokens->literal[tokens->count++] = m->data[pos++];
+                len = next; //a próxima volta usa essa busca em vez de repetir
+                distance = next_distance;
+                known = 1;
+                continue;
+            }
+        }
+
+        size_t i = tokens->count++;
+        if (len == 0) {
+            tokens->length[i] = 0;
+            tokens->literal[i] = m->data[pos];
+            pos++;
+            run++;
+            continue;
+        }
+
+        tokens->length[i] = len;
+        tokens->distance[i] = distance;
+        run = 0;
+        if (m->level > 1) { //nível 1: o meio das cópias não entra nas correntes (mais rápido, cópias piores)
+            for (uint64_t p = pos + 1; p < pos + len; p++) lz_insert(m, p);
+        }
+        pos += len;
+    }
+}
+
+// As quatro tabelas de cada bloco
+enum { LZ_LITERALS, LZ_RUNS, LZ_LENGTHS, LZ_DISTANCES, LZ_TABLES };
+
+// Um valor com faixas: conta a faixa em freq (se freq != NULL) ou escreve código + bits extras
+static inline void lz_put_value(uint32_t v, uint32_t small, int offset, uint64_t* freq, const HuffmanCode* codes,
+                                BitWriter* bits, HuffWriter* out) {
+    int symbol, extra_bits;
+    uint32_t extra;
+    lz_bucket(v, small, offset, &symbol, &extra, &extra_bits);
+    if (freq) {
+        freq[symbol]++;
+        return;
+    }
+    bit_writer_put(bits, out, codes[symbol].code, codes[symbol].length);
+    if (extra_bits) bit_writer_put(bits, out, extra, extra_bits);
+}
+
+/*Percorre os tokens como sequências: [quantos literais][os literais][cópia].
+Com freq: só conta os símbolos de cada tabela. Com codes: escreve os bits.*/
+static void lz_emit_block(const LzTokens* tokens, uint64_t freq[LZ_TABLES][256], HuffmanCode codes[LZ_TABLES][256],
+                          BitWriter* bits, HuffWriter* out) {
+    size_t i = 0;
+    while (i < tokens->count) {
+        size_t run = 0;
+        while (i + run < tokens->count && tokens->length[i + run] == 0) run++;
+
+        lz_put_value((uint32_t)run, LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET, freq ? freq[LZ_RUNS] : NULL,
+                     codes ? codes[LZ_RUNS] : NULL, bits, out);
+        for (; run > 0; run--, i++) {
+            unsigned char literal = tokens->literal[i];
+            if (freq) freq[LZ_LITERALS][literal]++;
+            else bit_writer_put(bits, out, codes[LZ_LITERALS][literal].code, codes[LZ_LITERALS][literal].length);
+        }
+        if (i == tokens->count) break; //o bloco terminou em literais: sem cópia no fim
+
+        lz_put_value(tokens->length[i] - HUFF_LZ_MIN_MATCH, LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET,
+                     freq ? freq[LZ_LENGTHS] : NULL, codes ? codes[LZ_LENGTHS] : NULL, bits, out);
+        lz_put_value(tokens->distance[i] - 1, LZ_DISTANCE_SMALL, LZ_DISTANCE_OFFSET,
+                     freq ? freq[LZ_DISTANCES] : NULL, codes ? codes[LZ_DISTANCES] : NULL, bits, out);
+        i++;
+    }
+}
+
+/*Compacta input com LZ77 (nível 0 a 9; fora disso usa HUFF_LZ_DEFAULT_LEVEL) + Huffman.
+Retorna 1 se deu certo.*/
+int compress_lz(FILE* input, FILE* output, int level) {
+    if (level < 0 || level > 9) level = HUFF_LZ_DEFAULT_LEVEL;
+
+    HuffReader reader;
+    HuffWriter whole, writer, block;
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    // 1. Arquivo inteiro na memória: mapeado, ou copiado bloco a bloco
+    const unsigned char* data = NULL;
+    uint64_t size = 0;
+    int ok = huff_writer_open_memory(&whole, HUFF_IO_BLOCK_SIZE);
+    size_t got;
+    if (ok && reader.map) {
+        huff_reader_refill(&reader);
+        data = reader.data;
+        size = reader.len;
+    } else if (ok) {
+        while ((got = huff_reader_refill(&reader)) > 0) huff_write_bytes(&whole, reader.data, got);
+        data = whole.data;
+        size = whole.pos;
+        ok = !whole.error;
+    }
+
+    LzMatcher* m = malloc(sizeof(LzMatcher));
+    LzTokens tokens;
+    tokens.length = malloc(sizeof(uint32_t) * HUFF_LZ_BLOCK_SIZE);
+    tokens.distance = malloc(sizeof(uint32_t) * HUFF_LZ_BLOCK_SIZE);
+    tokens.literal = malloc(HUFF_LZ_BLOCK_SIZE);
+    if (m) m->prev = level > 0 ? malloc(sizeof(uint32_t) * HUFF_LZ_WINDOW) : NULL;
+    if (!m || (level > 0 && !m->prev) || !tokens.length || !tokens.distance || !tokens.literal) {
+        perror("Erro ao alocar o LZ77");
+        ok = 0;
+    }
+    int opened = ok && huff_writer_open_memory(&block, HUFF_LZ_BLOCK_SIZE);
+    if (opened && !huff_writer_open(&writer, output, 0)) {
+        huff_writer_close(&block);
+        opened = 0;
+    }
+    ok = ok && opened;
+
+    if (ok) {
+        m->data = data;
+        m->size = size;
+        m->level = level;
+        m->chain = lz_levels[level].chain;
+        m->good = lz_levels[level].good;
+        m->nice = lz_levels[level].nice;
+        m->lazy = lz_levels[level].lazy;
+        memset(m->head, 0, sizeof(m->head));
+        lz_set_bits(m->run_bits, NULL);
+        lz_set_bits(m->length_bits, NULL);
+        lz_set_bits(m->distance_bits, NULL);
+
+        huff_write_bytes(&writer, (const unsigned char*)HUFF_LZ_MAGIC, 4);
+        huff_write_byte(&writer, HUFF_LZ_VERSION);
+        huff_write_byte(&writer, (unsigned char)level);
+        huff_write_byte(&writer, HUFF_LZ_WINDOW_BITS);
+        huff_write_byte(&writer, 0);
+        huff_write_u64(&writer, size);
+    }
+
+    for (uint64_t start = 0; ok && start < size; start += HUFF_LZ_BLOCK_SIZE) {
+        uint64_t end = size - start < HUFF_LZ_BLOCK_SIZE ? size : start + HUFF_LZ_BLOCK_SIZE;
+
+        // 2. Tokens do bloco
+        lz_estimate_literals(m, start, end);
+        lz_parse_block(m, start, end, &tokens);
+
+        // 3. Frequências das quatro tabelas
+        uint64_t freq[LZ_TABLES][256] = {{0}};
+        lz_emit_block(&tokens, freq, NULL, NULL, NULL);
+
+        unsigned char lengths[LZ_TABLES][256];
+        HuffmanCode codes[LZ_TABLES][256];
+        for (int t = 0; ok && t < LZ_TABLES; t++) {
+            ok = huff_code_lengths(freq[t], HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths[t]) &&
+                 build_canonical_codes(lengths[t], codes[t]);
+        }
+        if (!ok) {
+            perror("Erro ao montar os códigos");
+            break;
+        }
+        lz_set_bits(m->run_bits, lengths[LZ_RUNS]); //estimativa das cópias do próximo bloco
+        lz_set_bits(m->length_bits, lengths[LZ_LENGTHS]);
+        lz_set_bits(m->distance_bits, lengths[LZ_DISTANCES]);
+
+        // 4. Bits do bloco num buffer (o tamanho vai no registro antes deles)
+        block.pos = 0;
+        BitWriter bits = {0, 0};
+        lz_emit_block(&tokens, NULL, codes, &bits, &block);
+        bit_writer_finish(&bits, &block);
+        if (block.error) {
+            ok = 0;
+            break;
+        }
+
+        // 5. Registro do bloco
+        huff_write_u32(&writer, (uint32_t)(end - start));
+        huff_write_u32(&writer, (uint32_t)block.pos);
+        for (int t = 0; t < LZ_TABLES; t++) write_code_lengths(&writer, lengths[t]);
+        huff_write_bytes(&writer, block.data, block.pos);
+    }
+
+    if (opened) {
+        huff_writer_close(&block);
+        if (!huff_writer_close(&writer)) ok = 0;
+    }
+    if (m) free(m->prev);
+    free(m);
+    free(tokens.length);
+    free(tokens.distance);
+    free(tokens.literal);
+    huff_writer_close(&whole);
+    huff_reader_close(&reader);
+    return ok;
+}
+
+// Leitura de bits do bloco, do mais significativo para o menos (igual a huff_decode_stream)
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+    uint64_t acc;
+    int count;
+} LzBits;
+
+static inline void lz_bits_refill(LzBits* in) {
+    while (in->count <= 56 && in->p < in->end) {
+        in->acc |= (uint64_t)*in->p++ << (56 - in->count);
+        in->count += 8;
+    }
+}
+
+// Próximo símbolo da tabela (-1 = bits acabaram ou código inválido)
+static inline int lz_decode_symbol(LzBits* in, const HuffDecodeTable* table) {
+    lz_bits_refill(in);
+    HuffLookupEntry entry = table->entries[in->acc >> (64 - HUFF_LOOKUP_BITS)];
+    int symbol = entry.symbol;
+    int length = entry.length;
+    if (length == 0) symbol = decode_long_code(table, in->acc, &length);
+    if (length == 0 || length > in->count) return -1;
+
+    in->acc <<= length;
+    in->count -= length;
+    return symbol;
+}
+
+static inline int lz_read_bits(LzBits* in, int n, uint32_t* value) {
+    if (n == 0) {
+        *value = 0;
+        return 1;
+    }
+    lz_bits_refill(in);
+    if (n > in->count) return 0;
+    *value = (uint32_t)(in->acc >> (64 - n));
+    in->acc <<= n;
+    in->count -= n;
+    return 1;
+}
+
+// Valor com faixas: símbolo da tabela + bits extras. Retorna 0 se os bits acabaram
+static inline int lz_get_value(LzBits* in, const HuffDecodeTable* table, uint32_t small, int offset, uint64_t* value) {
+    uint32_t extra;
+    int symbol = lz_decode_symbol(in, table);
+    if (symbol < 0 || !lz_read_bits(in, lz_extra_bits(symbol, small, offset), &extra)) return 0;
+    *value = lz_unbucket(symbol, small, offset, extra);
+    return 1;
+}
+
+// Descompacta um bloco direto em out[*pos ..] (out já tem pelo menos a última janela: as cópias olham para trás)
+static int lz_decode_block(LzBits* in, const HuffDecodeTable tables[LZ_TABLES], unsigned char* out, size_t* pos, uint64_t raw) {
+    size_t here = *pos;
+    size_t end = here + (size_t)raw;
+
+    while (here < end) {
+        // 1. Literais
+        uint64_t run;
+        if (!lz_get_value(in, &tables[LZ_RUNS], LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET, &run) || run > end - here) return 0;
+        for (; run > 0; run--) {
+            int literal = lz_decode_symbol(in, &tables[LZ_LITERALS]);
+            if (literal < 0) return 0;
+            out[here++] = (unsigned char)literal;
+        }
+        if (here == end) break;
+
+        // 2. Cópia
+        uint64_t len, distance;
+        if (!lz_get_value(in, &tables[LZ_LENGTHS], LZ_LENGTH_SMALL, LZ_LENGTH_OFFSET, &len) ||
+            !lz_get_value(in, &tables[LZ_DISTANCES], LZ_DISTANCE_SMALL, LZ_DISTANCE_OFFSET, &distance)) {
+            return 0;
+        }
+        len += HUFF_LZ_MIN_MATCH;
+        distance += 1;
+        if (distance > here || len > end - here) return 0; //aponta antes do que foi guardado ou passa do bloco
+
+        //byte a byte: a cópia pode começar dentro dela mesma (distância < comprimento)
+        unsigned char* dst = out + here;
+        const unsigned char* src = dst - distance;
+        for (uint64_t k = 0; k < len; k++) dst[k] = src[k];
+        here += len;
+    }
+    *pos = here;
+    return 1;
+}
+
+/*Abre espaço para mais raw bytes no histórico: mantém só a última janela (as cópias
+não olham mais longe que isso) e só aumenta o buffer se nem assim couber.
+Retorna 0 se faltar memória.*/
+static int lz_history_reserve(unsigned char** history, size_t* pos, size_t* capacity, size_t window, size_t raw,
+                              uint64_t original_size) {
+    if (raw <= *capacity - *pos) return 1;
+    if (*pos > window) {
+        memmove(*history, *history + (*pos - window), window);
+        *pos = window;
+        if (raw <= *capacity - *pos) return 1;
+    }
+
+    //folga de algumas janelas: a janela só é movida para o início a cada ~3 janelas decodificadas
+    uint64_t wanted = (uint64_t)*pos + raw;
+    uint64_t roomy = original_size < 4 * (uint64_t)window ? original_size : 4 * (uint64_t)window;
+    if (wanted < roomy) wanted = roomy;
+    if (wanted > SIZE_MAX) return 0;
+
+    unsigned char* bigger = realloc(*history, (size_t)wanted);
+    if (!bigger) {
+        perror("Erro ao alocar o histórico do LZ77");
+        return 0;
+    }
+    *history = bigger;
+    *capacity = (size_t)wanted;
+    return 1;
+}
+
+/*Descompacta um arquivo gerado por compress_lz(). Retorna 1 se deu certo.
+O tamanho original do cabeçalho não é usado para alocar nada: com a saída mapeada
+(huff_writer_open_sized) os blocos são decodificados direto no arquivo; senão só a
+última janela fica na memória e cada bloco vai para a saída assim que termina.*/
+int decompress_lz(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    rewind(input);
+    uint64_t file_size;
+    if (!huff_file_size(input, &file_size)) file_size = UINT64_MAX; //pipe: sem esse limite
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    unsigned char scratch[HUFF_LZ_HEADER_SIZE];
+    const unsigned char* header;
+    int ok = huff_reader_take(&reader, HUFF_LZ_HEADER_SIZE, scratch, &header) == HUFF_LZ_HEADER_SIZE &&
+             memcmp(header, HUFF_LZ_MAGIC, 4) == 0 && header[4] == HUFF_LZ_VERSION && header[6] <= 30;
+    uint64_t original_size = ok ? huff_get_u64(header + 8) : 0;
+    size_t window = ok && header[6] ? (size_t)1 << header[6] : (size_t)1 << 20; //0: arquivo de antes desse campo (1 MiB)
+
+    //cada byte de bits gera no máximo HUFF_LZ_MAX_EXPANSION bytes: mais que isso só pode ser cabeçalho corrompido
+    if (ok && original_size / HUFF_LZ_MAX_EXPANSION > file_size) ok = 0;
+
+    HuffDecodeTable* tables = ok ? malloc(LZ_TABLES * sizeof(HuffDecodeTable)) : NULL;
+    if (!tables || !huff_writer_open_sized(&writer, output, original_size)) {
+        free(tables);
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    unsigned char* packed_scratch = NULL;
+    unsigned char* history = NULL; //só sem o mapeamento: a última janela + o bloco atual
+    size_t history_pos = 0, history_capacity = 0;
+    uint64_t done = 0;
+
+    while (ok && done < original_size) {
+        unsigned char record_scratch[8];
+        const unsigned char* record;
+        if (huff_reader_take(&reader, 8, record_scratch, &record) != 8) {
+            ok = 0;
+            break;
+        }
+        uint32_t raw = huff_get_u32(record);
+        uint32_t packed = huff_get_u32(record + 4);
+        if (raw == 0 || raw > original_size - done || packed > file_size ||
+            raw / HUFF_LZ_MAX_EXPANSION > packed) {
+            ok = 0;
+            break;
+        }
+
+        unsigned char lengths[256];
+        for (int t = 0; ok && t < LZ_TABLES; t++) {
+            ok = read_code_lengths(&reader, lengths) && build_decode_table_from_lengths(lengths, &tables[t]);
+        }
+        if (!ok) break;
+
+        const unsigned char* bits_data;
+        if (!reader.map) { //modo em blocos: o payload pode atravessar blocos de leitura
+            unsigned char* bigger = realloc(packed_scratch, packed ? packed : 1);
+            if (!bigger) {
+                ok = 0;
+                break;
+            }
+            packed_scratch = bigger;
+        }
+        if (huff_reader_take(&reader, packed, packed_scratch, &bits_data) != packed) {
+            ok = 0;
+            break;
+        }
+
+        LzBits in = {bits_data, bits_data + packed, 0, 0};
+        if (writer.map) { //os blocos anteriores já estão no arquivo mapeado
+            ok = lz_decode_block(&in, tables, writer.data, &writer.pos, raw);
+        } else {
+            ok = lz_history_reserve(&history, &history_pos, &history_capacity, window, raw, original_size) &&
+                 lz_decode_block(&in, tables, history, &history_pos, raw);
+            if (ok) huff_write_bytes(&writer, history + history_pos - raw, raw);
+        }
+        done += raw;
+    }
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    free(history);
+    free(packed_scratch);
+    free(tables);
+    huff_reader_close(&reader);
+    return ok;
+}
+
+#endif // HUFF_LZ_H
@@ -0,0 +1,243 @@
+/*
+    HUFFMAN DE ORDEM 1 (uma tabela por byte anterior)
+
+    Os outros modos usam uma tabela só (ordem 0): o código de 'u' é o mesmo
+    em qualquer lugar do arquivo. Em texto, o byte anterior diz muito sobre o
+    próximo: depois de 'q' quase sempre vem 'u', depois de '\n' vem espaço ou
+    maiúscula. Com uma tabela por byte anterior (o "contexto"), 'u' depois de
+    'q' custa 1 bit em vez de 5 ou 6.
+
+    Guardar 256 tabelas custaria caro em arquivos pequenos, então cada
+    contexto só ganha tabela própria quando compensa:
+
+        bits com a tabela própria + bytes dos comprimentos dela × 8
+        <  bits com a tabela de ordem 0
+
+    Os outros (contextos raros ou parecidos com a média) usam a tabela de
+    ordem 0, que sempre existe.
+
+    Layout do arquivo (inteiros em little-endian, ver huff_write_u32):
+
+    [4 bytes]   "HUFO"
+    [1 byte]    versão
+    [8 bytes]   tamanho original (u64)
+    [...]       comprimentos da tabela de ordem 0 (write_code_lengths)
+    [32 bytes]  mapa: bit c ligado = o contexto c tem tabela própria
+    [...]       comprimentos de cada contexto ligado, em ordem crescente de c
+    [...]       bits; o primeiro byte do arquivo usa o contexto 0
+
+    O descompactador monta uma tabela de decodificação rápida
+    (build_decode_table_from_lengths) para cada contexto ligado e troca de
+    tabela a cada byte.
+*/
+
+#ifndef HUFF_ORDER1_H
+#define HUFF_ORDER1_H
+
+#include "huffman.h"
+
+#define HUFF_ORDER1_VERSION 1
+#define HUFF_ORDER1_HEADER_SIZE 13 //magic + versão + tamanho original
+
+#ifndef HUFF_ORDER1_MIN_CONTEXT
+#define HUFF_ORDER1_MIN_CONTEXT 32 //contextos com menos bytes que isso nem tentam ter tabela própria
+#endif
+
+static uint64_t order1_bits(const uint64_t freq[256], const unsigned char lengths[256]) {
+    uint64_t bits = 0;
+    for (int s = 0; s < 256; s++) bits += freq[s] * lengths[s];
+    return bits;
+}
+
+/*Compacta input no modo de ordem 1. Lê o arquivo duas vezes (contagem e códigos),
+então input precisa aceitar rewind. Retorna 1 se deu certo.*/
+int compress_order1(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    // 1. Frequências por contexto (256 × 256) e de ordem 0
+    uint64_t (*freq)[256] = calloc(256, sizeof(*freq));
+    HuffmanCode (*codes)[256] = malloc(256 * sizeof(*codes));
+    if (!freq || !codes) {
+        perror("Erro ao alocar as tabelas de contexto");
+        free(freq);
+        free(codes);
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    uint64_t freq0[256] = {0};
+    uint64_t original_size = 0;
+    unsigned char prev = 0;
+    size_t got;
+    while ((got = huff_reader_refill(&reader)) > 0) {
+        for (size_t i = 0; i < got; i++) {
+            freq[prev][reader.data[i]]++;
+            prev = reader.data[i];
+        }
+        original_size += got;
+    }
+    for (int c = 0; c < 256; c++) {
+        for (int s = 0; s < 256; s++) freq0[s] += freq[c][s];
+    }
+
+    // 2. Tabela de ordem 0 e, para cada contexto, tabela própria só se compensar
+    unsigned char lengths0[256];
+    unsigned char (*lengths)[256] = malloc(256 * sizeof(*lengths));
+    unsigned char own[32] = {0};
+    HuffmanCode codes0[256];
+    const HuffmanCode* table_for[256]; //tabela usada depois de cada byte
+
+    int ok = lengths && huff_code_lengths(freq0, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths0) &&
+             build_canonical_codes(lengths0, codes0);
+
+    for (int c = 0; ok && c < 256; c++) {
+        table_for[c] = codes0;
+
+        uint64_t total = 0;
+        for (int s = 0; s < 256; s++) total += freq[c][s];
+        if (total < HUFF_ORDER1_MIN_CONTEXT) continue;
+
+        if (!huff_code_lengths(freq[c], HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths[c])) {
+            ok = 0;
+            break;
+        }
+        uint64_t own_bits = order1_bits(freq[c], lengths[c]) + 8 * (uint64_t)code_lengths_size(lengths[c]);
+        if (own_bits >= order1_bits(freq[c], lengths0)) continue;
+
+        if (!build_canonical_codes(lengths[c], codes[c])) {
+            ok = 0;
+            break;
+        }
+        own[c / 8] |= (unsigned char)(1u << (c % 8));
+        table_for[c] = codes[c];
+    }
+
+    if (!ok) perror("Erro ao montar os códigos");
+    if (ok && !huff_writer_open(&writer, output, 0)) ok = 0;
+
+    if (ok) {
+        // 3. Cabeçalho
+        huff_write_bytes(&writer, (const unsigned char*)HUFF_ORDER1_MAGIC, 4);
+        huff_write_byte(&writer, HUFF_ORDER1_VERSION);
+        huff_write_u64(&writer, original_size);
+        write_code_lengths(&writer, lengths0);
+        huff_write_bytes(&writer, own, sizeof(own));
+        for (int c = 0; c < 256; c++) {
+            if (own[c / 8] & (1u << (c % 8))) write_code_lengths(&writer, lengths[c]);
+        }
+
+        // 4. Bits, cada byte com a tabela do byte anterior
+        BitWriter bits = {0, 0};
+        prev = 0;
+        huff_reader_rewind(&reader);
+        while ((got = huff_reader_refill(&reader)) > 0) {
+            for (size_t i = 0; i < got; i++) {
+                HuffmanCode code = table_for[prev][reader.data[i]];
+                bit_writer_put(&bits, &writer, code.code, code.length);
+                prev = reader.data[i];
+            }
+        }
+        bit_writer_finish(&bits, &writer);
+        ok = huff_writer_close(&writer);
+    }
+
+    free(freq);
+    free(codes);
+    free(lengths);
+    huff_reader_close(&reader);
+    return ok;
+}
+
+/*Igual a huff_decode_stream(), mas a tabela muda a cada byte (tables[byte anterior]).
+Retorna quantos bytes foram escritos.*/
+uint64_t order1_decode_stream(HuffReader* in, HuffWriter* out, HuffDecodeTable* const tables[256], uint64_t max_symbols) {
+    uint64_t written = 0;
+    uint64_t acc = 0;
+    int bit_count = 0;
+    unsigned char prev = 0;
+
+    while (written < max_symbols) {
+        while (bit_count <= 56) {
+            if (in->pos == in->len && huff_reader_refill(in) == 0) break;
+            acc |= (uint64_t)in->data[in->pos++] << (56 - bit_count);
+            bit_count += 8;
+        }
+
+        const HuffDecodeTable* table = tables[prev];
+        HuffLookupEntry entry = table->entries[acc >> (64 - HUFF_LOOKUP_BITS)];
+        int symbol = entry.symbol;
+        int length = entry.length;
+        if (length == 0) symbol = decode_long_code(table, acc, &length);
+
+        if (length == 0 || length > bit_count) break; //corpo truncado/corrompido
+
+        acc <<= length;
+        bit_count -= length;
+
+        huff_write_byte(out, (unsigned char)symbol);
+        prev = (unsigned char)symbol;
+        written++;
+    }
+    return written;
+}
+
+// Descompacta um arquivo gerado por compress_order1(). Retorna 1 se deu certo
+int decompress_order1(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    rewind(input);
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+
+    // 1. Cabeçalho e mapa de contextos
+    unsigned char scratch[HUFF_ORDER1_HEADER_SIZE];
+    const unsigned char* header;
+    unsigned char lengths[256];
+    unsigned char own[32];
+    int ok = huff_reader_take(&reader, HUFF_ORDER1_HEADER_SIZE, scratch, &header) == HUFF_ORDER1_HEADER_SIZE &&
+             memcmp(header, HUFF_ORDER1_MAGIC, 4) == 0 && header[4] == HUFF_ORDER1_VERSION;
+    uint64_t original_size = ok ? huff_get_u64(header + 5) : 0;
+
+    HuffDecodeTable* table0 = malloc(sizeof(HuffDecodeTable));
+    ok = ok && table0 && read_code_lengths(&reader, lengths) && build_decode_table_from_lengths(lengths, table0);
+    for (int i = 0; ok && i < 32; i++) {
+        int byte = huff_read_byte(&reader);
+        if (byte == EOF) ok = 0;
+        else own[i] = (unsigned char)byte;
+    }
+
+    // 2. Uma tabela de decodificação por contexto ligado; os outros apontam para a de ordem 0
+    int own_count = 0;
+    for (int c = 0; ok && c < 256; c++) {
+        if (own[c / 8] & (1u << (c % 8))) own_count++;
+    }
+    HuffDecodeTable* context_tables = (ok && own_count > 0) ? malloc((size_t)own_count * sizeof(HuffDecodeTable)) : NULL;
+    if (own_count > 0 && !context_tables) ok = 0;
+
+    HuffDecodeTable* tables[256];
+    int next = 0;
+    for (int c = 0; ok && c < 256; c++) {
+        tables[c] = table0;
+        if (!(own[c / 8] & (1u << (c % 8)))) continue;
+
+        HuffDecodeTable* table = &context_tables[next++];
+        if (!read_code_lengths(&reader, lengths) || !build_decode_table_from_lengths(lengths, table)) ok = 0;
+        tables[c] = table;
+    }
+
+    // 3. Bits, até escrever original_size bytes
+    if (ok && huff_writer_open(&writer, output, 0)) {
+        ok = order1_decode_stream(&reader, &writer, tables, original_size) == original_size;
+        if (!huff_writer_close(&writer)) ok = 0;
+    } else {
+        ok = 0;
+    }
+
+    free(context_tables);
+    free(table0);
+    huff_reader_close(&reader);
+    return ok;
+}
+
+#endif // HUFF_ORDER1_H
@@ -0,0 +1,148 @@
+/*
+    POOL DE THREADS ("for paralelo")
+
+    As threads são criadas uma vez e ficam esperando trabalho. huff_pool_run()
+    recebe uma função e uma quantidade de tarefas: cada thread pega o próximo
+    índice livre, executa task(ctx, índice) e volta para pegar outro, até
+    acabarem. A thread que chamou huff_pool_run() também trabalha, então um
+    pool com 1 thread não cria thread nenhuma.
+
+    Exemplo: compactar 10 pedaços com 4 threads
+
+    huff_pool_run(pool, 10, compress_chunk_task, &job);
+    // volta só depois que compress_chunk_task(&job, 0) ... (&job, 9) terminaram
+
+    Compilar com: gcc main.c -o programa -pthread
+*/
+
+#ifndef HUFF_POOL_H
+#define HUFF_POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef void (*HuffTask)(void* ctx, size_t index);
+
+typedef struct {
+    pthread_t* threads;       //threads extras (além de quem chama huff_pool_run)
+    int thread_count;         //total de threads trabalhando, contando quem chama
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready; //acorda as threads quando chega trabalho novo
+    pthread_cond_t work_done;  //acorda quem chamou quando a última tarefa termina
+    HuffTask task;
+    void* ctx;
+    size_t next;              //próximo índice ainda não pego
+    size_t total;             //quantas tarefas nessa rodada
+    size_t finished;          //quantas já terminaram
+    unsigned long generation; //muda a cada huff_pool_run, para as threads saberem que há rodada nova
+    int stop;
+} HuffPool;
+
+// Quantos núcleos a máquina tem (pelo menos 1)
+int huff_cpu_count() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// Pega tarefas até acabarem; chamada com o lock travado e devolve com o lock travado
+void huff_pool_drain(HuffPool* pool) {
+    while (pool->next < pool->total) {
+        size_t index = pool->next++;
+        HuffTask task = pool->task;
+        void* ctx = pool->ctx;
+
+        pthread_mutex_unlock(&pool->lock);
+        task(ctx, index); //a tarefa roda sem o lock: as outras threads continuam pegando índices
+        pthread_mutex_lock(&pool->lock);
+
+        pool->finished++;
+        if (pool->finished == pool->total) pthread_cond_broadcast(&pool->work_done);
+    }
+}
+
+void* huff_pool_worker(void* arg) {
+    HuffPool* pool = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stop) break;
+
+        seen = pool->generation;
+        huff_pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// threads <= 0 usa todos os núcleos
+HuffPool* huff_pool_create(int threads) {
+    if (threads <= 0) threads = huff_cpu_count();
+
+    HuffPool* pool = calloc(1, sizeof(HuffPool));
+    if (!pool) return NULL;
+
+    pool->thread_count = threads;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    if (threads > 1) {
+        pool->threads = malloc(sizeof(pthread_t) * (threads - 1));
+        for (int i = 0; pool->threads && i < threads - 1; i++) {
+            if (pthread_create(&pool->threads[i], NULL, huff_pool_worker, pool) != 0) {
+                pool->thread_count = i + 1; //segue com as threads que conseguiu criar
+                break;
+            }
+        }
+        if (!pool->threads) pool->thread_count = 1;
+    }
+    return pool;
+}
+
+// Executa task(ctx, 0) ... task(ctx, count-1) em paralelo e só retorna quando todas terminarem
+void huff_pool_run(HuffPool* pool, size_t count, HuffTask task, void* ctx) {
+    if (count == 0) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->next = 0;
+    pool->total = count;
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    huff_pool_drain(pool); //quem chamou também trabalha
+
+    while (pool->finished < pool->total) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void huff_pool_destroy(HuffPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count - 1; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->threads);
+    free(pool);
+}
+
+#endif // HUFF_POOL_H
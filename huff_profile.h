@@ -0,0 +1,146 @@
+/*
+    MEDIÇÃO POR ETAPA (desligada por padrão)
+
+    Quando uma compactação demora, a pergunta é: o tempo foi para
+    create_huff_queue(), build_huffman_tree(), write_header(), compactor()
+    ou para a leitura/escrita? Compilando com -DHUFF_PROFILE cada etapa
+    registra:
+
+    - quantas vezes foi chamada;
+    - quantos bytes processou (entrada na compactação, saída na descompactação);
+    - tempo de relógio (CLOCK_MONOTONIC) e de CPU da thread (CLOCK_THREAD_CPUTIME_ID).
+
+    Sem -DHUFF_PROFILE as macros HUFF_PROFILE_BEGIN/END não geram código
+    nenhum e as funções abaixo nem existem.
+
+    As marcas ficam nas funções inteiras ou em blocos de pelo menos 64 KiB
+    (huff_reader_refill, huff_writer_flush, huff_encode_block...), nunca no
+    laço de cada byte: são 2 leituras de relógio por chamada, o que fica
+    bem abaixo de 1% do tempo da etapa.
+
+    Os tempos são inclusivos: "io_read" também está dentro de "histogram"
+    quando create_huff_queue() lê o arquivo, e "encode_block" dentro de
+    "compactor". No modo em pedaços (várias threads), o tempo de CPU é a
+    soma de todas as threads e pode passar do tempo de relógio.
+
+    Uso:
+    gcc -O2 -DHUFF_PROFILE main_modificado.c -o programa -pthread
+    ./programa            → tabela no stderr quando o programa termina
+    huff_profile_get(...) → os números, para quem quiser guardar (ver benchmark_codec.c)
+*/
+
+#ifndef HUFF_PROFILE_H
+#define HUFF_PROFILE_H
+
+#ifdef HUFF_PROFILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+typedef enum {
+    HUFF_STAGE_HISTOGRAM,    //create_huff_queue(): frequências + filas
+    HUFF_STAGE_TREE,         //build_huffman_tree()
+    HUFF_STAGE_CODE_LENGTHS, //huff_code_lengths(): comprimentos sem árvore (formatos novos)
+    HUFF_STAGE_HEADER,       //write_header()
+    HUFF_STAGE_COMPACTOR,    //compactor()
+    HUFF_STAGE_ENCODE_BLOCK, //huff_encode_block(): bytes → bits, todos os formatos
+    HUFF_STAGE_READ_HEADER,  //read_header()
+    HUFF_STAGE_READ_TREE,    //read_tree() (a chamada de fora, não cada recursão)
+    HUFF_STAGE_DECOMPRESS,   //decompress()
+    HUFF_STAGE_DECODE,       //huff_decode_stream(): bits → bytes, todos os formatos
+    HUFF_STAGE_IO_READ,      //huff_reader_refill() com fread (mapeado não lê nada)
+    HUFF_STAGE_IO_WRITE,     //huff_writer_flush() com fwrite
+    HUFF_STAGE_COUNT
+} HuffStage;
+
+static const char* const huff_stage_names[HUFF_STAGE_COUNT] = {
+    "histogram", "tree", "code_lengths", "header", "compactor", "encode_block",
+    "read_header", "read_tree", "decompress", "decode", "io_read", "io_write",
+};
+
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} HuffStageStats;
+
+typedef struct {
+    uint64_t wall_ns;
+    uint64_t cpu_ns;
+} HuffProfileMark;
+
+static HuffStageStats huff_profile_stats[HUFF_STAGE_COUNT];
+static pthread_mutex_t huff_profile_lock = PTHREAD_MUTEX_INITIALIZER; //as threads do modo em pedaços somam no mesmo lugar
+static int huff_profile_registered = 0;
+
+static inline uint64_t huff_profile_clock(clockid_t clock) {
+    struct timespec t;
+    clock_gettime(clock, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;
+}
+
+void huff_profile_dump(FILE* out) {
+    fprintf(out, "%-13s %10s %14s %12s %12s %10s\n", "etapa", "chamadas", "bytes", "relógio ms", "CPU ms", "MB/s");
+    for (int s = 0; s < HUFF_STAGE_COUNT; s++) {
+        HuffStageStats st = huff_profile_stats[s];
+        if (st.calls == 0) continue;
+        double seconds = st.wall_ns / 1e9;
+        fprintf(out, "%-13s %10llu %14llu %12.3f %12.3f %10.1f\n", huff_stage_names[s], (unsigned long long)st.calls,
+                (unsigned long long)st.bytes, st.wall_ns / 1e6, st.cpu_ns / 1e6, seconds > 0 ? st.bytes / 1e6 / seconds : 0.0);
+    }
+}
+
+static void huff_profile_dump_at_exit(void) {
+    huff_profile_dump(stderr);
+}
+
+static inline HuffProfileMark huff_profile_begin(void) {
+    HuffProfileMark mark = {huff_profile_clock(CLOCK_MONOTONIC), huff_profile_clock(CLOCK_THREAD_CPUTIME_ID)};
+    return mark;
+}
+
+static inline void huff_profile_end(HuffStage stage, const HuffProfileMark* mark, uint64_t bytes) {
+    uint64_t wall = huff_profile_clock(CLOCK_MONOTONIC) - mark->wall_ns;
+    uint64_t cpu = huff_profile_clock(CLOCK_THREAD_CPUTIME_ID) - mark->cpu_ns;
+
+    pthread_mutex_lock(&huff_profile_lock);
+    if (!huff_profile_registered) { //a tabela sai sozinha no fim do programa
+        huff_profile_registered = 1;
+        atexit(huff_profile_dump_at_exit);
+    }
+    HuffStageStats* st = &huff_profile_stats[stage];
+    st->calls++;
+    st->bytes += bytes;
+    st->wall_ns += wall;
+    st->cpu_ns += cpu;
+    pthread_mutex_unlock(&huff_profile_lock);
+}
+
+// Copia os contadores atuais para out[HUFF_STAGE_COUNT]
+void huff_profile_get(HuffStageStats out[HUFF_STAGE_COUNT]) {
+    pthread_mutex_lock(&huff_profile_lock);
+    for (int s = 0; s < HUFF_STAGE_COUNT; s++) out[s] = huff_profile_stats[s];
+    pthread_mutex_unlock(&huff_profile_lock);
+}
+
+void huff_profile_reset(void) {
+    pthread_mutex_lock(&huff_profile_lock);
+    for (int s = 0; s < HUFF_STAGE_COUNT; s++) huff_profile_stats[s] = (HuffStageStats){0, 0, 0, 0};
+    pthread_mutex_unlock(&huff_profile_lock);
+}
+
+#define HUFF_PROFILE_BEGIN(mark) HuffProfileMark mark = huff_profile_begin()
+#define HUFF_PROFILE_END(mark, stage, bytes) huff_profile_end((stage), &(mark), (uint64_t)(bytes))
+
+#else
+
+#define HUFF_PROFILE_BEGIN(mark) ((void)0)
+#define HUFF_PROFILE_END(mark, stage, bytes) ((void)0)
+
+#endif // HUFF_PROFILE
+
+#endif // HUFF_PROFILE_H
@@ -0,0 +1,140 @@
+/*
+    GUARDADO SEM COMPACTAR ("stored")
+
+    JPEG, zip, mp4... já vêm compactados: os 256 bytes aparecem quase na
+    mesma proporção e cada código de Huffman fica com 8 bits. O .huff sai
+    do tamanho do original + cabeçalho, e ainda pagamos para codificar e
+    decodificar cada byte.
+
+    Antes de escrever qualquer bit, o compactador calcula quanto os dados
+    vão ocupar (frequência × comprimento, como calculate_bits_trashed()) e,
+    se não ficar menor que o original, guarda os bytes como estão:
+
+    - arquivo inteiro (opção 1 e formato canônico): o formato "HUFR" abaixo;
+    - em pedaços (huff_chunked.h) e em fluxo (huff_stream.h): a decisão é
+      de cada bloco, com um modo "guardado" no registro do bloco.
+
+    Layout: "HUFR" | versão (1 byte) | tamanho original (u64) | bytes originais
+
+    Na descompactação, o kernel copia direto de um arquivo para o outro
+    (copy_file_range, no Linux), sem passar pela memória do programa. Se não
+    der (outro sistema, saída num pipe...), copiamos em blocos de 1 MiB.
+*/
+
+#ifndef HUFF_STORED_H
+#define HUFF_STORED_H
+
+#include "huffman.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+#define HUFF_STORED_VERSION 1
+#define HUFF_STORED_HEADER_SIZE 13 //magic + versão + tamanho original
+#define HUFF_STORED_COPY_BLOCK (1024 * 1024)
+
+/*1 se raw_size bytes guardados como estão não perdem para overhead bytes (cabeçalho,
+comprimentos...) + coded_bits bits (huff_block_cost(); UINT64_MAX = byte sem código).
+No empate, guardar ganha: descompactar vira uma cópia.*/
+int huff_store_is_smaller(uint64_t coded_bits, uint64_t overhead, uint64_t raw_size) {
+    if (coded_bits == UINT64_MAX) return 1;
+    return overhead + (coded_bits + 7) / 8 >= raw_size;
+}
+
+void write_stored_header(HuffWriter* writer, uint64_t original_size) {
+    huff_write_bytes(writer, (const unsigned char*)HUFF_STORED_MAGIC, 4);
+    huff_write_byte(writer, HUFF_STORED_VERSION);
+    huff_write_u64(writer, original_size);
+}
+
+// Cabeçalho + o conteúdo de reader, do começo ao fim. Retorna 1 se copiou exatamente original_size bytes
+int write_stored(HuffReader* reader, HuffWriter* writer, uint64_t original_size) {
+    write_stored_header(writer, original_size);
+
+    uint64_t copied = 0;
+    size_t got;
+    huff_reader_rewind(reader);
+    while ((got = huff_reader_refill(reader)) > 0) {
+        huff_write_bytes(writer, reader->data, got);
+        copied += got;
+    }
+    return copied == original_size && !writer->error;
+}
+
+// Guarda input (original_size bytes) em output sem compactar. Retorna 1 se deu certo
+int compress_stored(FILE* input, FILE* output, uint64_t original_size) {
+    HuffReader reader;
+    HuffWriter writer;
+    if (!huff_reader_open_mapped(&reader, input)) return 0;
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    int ok = write_stored(&reader, &writer, original_size);
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    return ok;
+}
+
+// Versão em memória: cabeçalho + os n bytes de data, em out
+int huff_stored_encode(const unsigned char* data, size_t n, HuffWriter* out) {
+    write_stored_header(out, n);
+    huff_write_bytes(out, data, n);
+    return !out->error;
+}
+
+/*Acrescenta a out o conteúdo dos n bytes de in (formato guardado). Retorna 0 se o
+cabeçalho não bater ou se o tamanho não for o do cabeçalho.*/
+int huff_stored_decode(const unsigned char* in, size_t n, HuffWriter* out) {
+    if (n < HUFF_STORED_HEADER_SIZE || memcmp(in, HUFF_STORED_MAGIC, 4) != 0 || in[4] != HUFF_STORED_VERSION) return 0;
+    if (huff_get_u64(in + 5) != n - HUFF_STORED_HEADER_SIZE) return 0;
+
+    huff_write_bytes(out, in + HUFF_STORED_HEADER_SIZE, n - HUFF_STORED_HEADER_SIZE);
+    return !out->error;
+}
+
+// Descompacta um arquivo gerado por compress_stored(): copia os bytes depois do cabeçalho. Retorna 1 se deu certo
+int decompress_stored(FILE* input, FILE* output) {
+    unsigned char header[HUFF_STORED_HEADER_SIZE];
+    rewind(input);
+    if (fread(header, 1, sizeof(header), input) != sizeof(header)) return 0;
+    if (memcmp(header, HUFF_STORED_MAGIC, 4) != 0 || header[4] != HUFF_STORED_VERSION) return 0;
+
+    uint64_t original_size = huff_get_u64(header + 5);
+    uint64_t copied = 0;
+    if (fflush(output) != 0) return 0;
+
+#if defined(__linux__) && defined(SYS_copy_file_range)
+    //O kernel copia de arquivo para arquivo. Pode copiar menos que o pedido: repete até acabar ou falhar
+    long long offset = HUFF_STORED_HEADER_SIZE;
+    while (copied < original_size) {
+        size_t want = original_size - copied < (1u << 30) ? (size_t)(original_size - copied) : (1u << 30);
+        long done = syscall(SYS_copy_file_range, fileno(input), &offset, fileno(output), NULL, want, 0);
+        if (done <= 0) break; //sem suporte (EXDEV, EINVAL em pipes...) ou fim do arquivo: segue pelo caminho comum
+        copied += (uint64_t)done;
+    }
+    if (copied > 0 && fseek(output, 0, SEEK_END) != 0) return 0; //o FILE* não viu o que o kernel escreveu
+#endif
+
+    // Caminho comum: blocos de 1 MiB (também termina o que copy_file_range não copiou)
+    unsigned char* block = copied < original_size ? malloc(HUFF_STORED_COPY_BLOCK) : NULL;
+    if (copied < original_size) {
+        if (!block || !huff_seek(input, HUFF_STORED_HEADER_SIZE + copied)) {
+            free(block);
+            return 0;
+        }
+        while (copied < original_size) {
+            size_t want = original_size - copied < HUFF_STORED_COPY_BLOCK ? (size_t)(original_size - copied) : HUFF_STORED_COPY_BLOCK;
+            size_t got = fread(block, 1, want, input);
+            if (got == 0 || fwrite(block, 1, got, output) != got) break;
+            copied += got;
+        }
+    }
+    free(block);
+    return copied == original_size;
+}
+
+#endif // HUFF_STORED_H
@@ -0,0 +1,255 @@
+/*
+    FORMATO EM FLUXO (stdin → stdout, memória limitada)
+
+    Os outros formatos contam as frequências do arquivo inteiro antes de
+    compactar, então precisam ler a entrada duas vezes (rewind). Um pipe
+    (ex.: produtor_de_logs | programa -c > logs.huff) não volta para o começo.
+
+    Aqui a entrada é lida em blocos de tamanho fixo e cada bloco é compactado
+    assim que chega: contar → códigos → bits → escrever. A memória usada fica
+    em torno de 2 blocos (entrada + saída), qualquer que seja o tamanho do fluxo.
+
+    Cada bloco pode trazer os próprios comprimentos de código ou reaproveitar
+    os do bloco anterior. O compactador calcula quantos bits o bloco gastaria
+    com cada opção (incluindo o cabeçalho dos comprimentos) e fica com a menor:
+    em logs, blocos seguidos costumam ter histogramas parecidos. Se nem a
+    menor fica abaixo do tamanho do bloco, ele vai sem compactar
+    (HUFF_STREAM_STORED, ver huff_stored.h).
+
+    Layout (inteiros em little-endian, ver huff_write_u32):
+
+    [8 bytes]  "HUFS" | versão (1 byte) | tamanho do bloco em KiB, arredondado para cima (u24)
+    [bloco]    tamanho original (u32) | tamanho compactado (u32) | modo (1 byte)
+               | comprimentos (só no modo HUFF_STREAM_NEW_TABLE) | bits (ou os bytes originais, no modo guardado)
+    [bloco] ...
+    [fim]      0 (u32) | 0 (u32) | HUFF_STREAM_END | total de bytes originais (u64)
+
+    O tamanho compactado inclui os comprimentos e os bits, então o
+    descompactador lê cada bloco inteiro de uma vez e também não precisa
+    voltar atrás. Com o tamanho do bloco no cabeçalho, um registro corrompido
+    não faz o descompactador alocar mais que isso (a memória continua em
+    torno de 2 blocos). Fluxos gravados antes desse campo têm 0 ali e valem
+    como HUFF_STREAM_BLOCK_SIZE.
+*/
+
+#ifndef HUFF_STREAM_H
+#define HUFF_STREAM_H
+
+#include "huffman.h"
+
+#define HUFF_STREAM_VERSION 1
+#define HUFF_STREAM_HEADER_SIZE 8
+#define HUFF_STREAM_RECORD_SIZE 9 //u32 original + u32 compactado + 1 byte de modo
+
+#ifndef HUFF_STREAM_BLOCK_SIZE
+#define HUFF_STREAM_BLOCK_SIZE (1024 * 1024)
+#endif
+
+// Maior bloco compactado possível para um bloco original de raw bytes (códigos de até 32 bits + comprimentos)
+#define HUFF_STREAM_PACKED_BOUND(raw) ((size_t)(raw) * 4 + 256)
+
+// Modos de um bloco
+enum {
+    HUFF_STREAM_NEW_TABLE = 0,   //comprimentos + bits
+    HUFF_STREAM_REUSE_TABLE = 1, //só bits, com os códigos do bloco anterior
+    HUFF_STREAM_END = 2,         //fim do fluxo
+    HUFF_STREAM_STORED = 3       //bytes originais; a tabela do bloco anterior continua valendo
+};
+
+/*Compacta input em blocos de block_size bytes, lendo só para frente (serve para stdin).
+Retorna 1 se deu certo.*/
+int compress_stream(FILE* input, FILE* output, size_t block_size) {
+    if (block_size == 0) block_size = HUFF_STREAM_BLOCK_SIZE;
+    if (block_size > UINT32_MAX / 4) block_size = UINT32_MAX / 4; //o tamanho compactado precisa caber no u32
+
+    HuffReader reader;
+    HuffWriter writer, block;
+    unsigned char* scratch = malloc(block_size);
+    if (!scratch || !huff_reader_open(&reader, input, 0)) {
+        free(scratch);
+        return 0;
+    }
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        free(scratch);
+        return 0;
+    }
+    if (!huff_writer_open_memory(&block, block_size / 2 + 1024)) { //o bloco compactado, antes de saber o tamanho dele
+        huff_writer_close(&writer);
+        huff_reader_close(&reader);
+        free(scratch);
+        return 0;
+    }
+
+    // 1. Cabeçalho
+    huff_write_bytes(&writer, (const unsigned char*)HUFF_STREAM_MAGIC, 4);
+    huff_write_byte(&writer, HUFF_STREAM_VERSION);
+    uint32_t block_kib = (uint32_t)((block_size + 1023) / 1024); //block_size <= UINT32_MAX / 4: cabe em 24 bits
+    for (int i = 0; i < 3; i++) huff_write_byte(&writer, (unsigned char)(block_kib >> (8 * i)));
+
+    unsigned char previous[256] = {0}; //comprimentos do último bloco com tabela
+    HuffmanCode huff_table[256];
+    uint64_t total = 0;
+    int ok = 1;
+
+    while (ok) {
+        const unsigned char* data;
+        size_t got = huff_reader_take(&reader, block_size, scratch, &data);
+        if (got == 0) break;
+
+        // 2. Frequências e comprimentos novos deste bloco
+        uint64_t freq[256] = {0};
+        unsigned char lengths[256];
+        count_frequencies(data, got, freq);
+        if (!huff_code_lengths(freq, HUFF_MAX_CODE_LENGTH, HUFF_DEFAULT_BUILDER, lengths)) {
+            ok = 0;
+            break;
+        }
+
+        // 3. Tabela nova (bits + cabeçalho dos comprimentos) ou a anterior (só bits)?
+        block.pos = 0;
+        write_code_lengths(&block, lengths);
+        uint64_t new_cost = huff_block_cost(freq, lengths) + block.pos * 8;
+        uint64_t reuse_cost = total > 0 ? huff_block_cost(freq, previous) : UINT64_MAX;
+
+        unsigned char mode = HUFF_STREAM_NEW_TABLE;
+        if (huff_store_is_smaller(reuse_cost < new_cost ? reuse_cost : new_cost, 0, got)) {
+            //nem reaproveitando a tabela encolhe: o bloco vai como está, sem mexer na tabela anterior
+            huff_write_u32(&writer, (uint32_t)got);
+            huff_write_u32(&writer, (uint32_t)got);
+            huff_write_byte(&writer, HUFF_STREAM_STORED);
+            huff_write_bytes(&writer, data, got);
+            total += got;
+            continue;
+        } else if (reuse_cost <= new_cost) {
+            mode = HUFF_STREAM_REUSE_TABLE;
+            block.pos = 0; //descarta os comprimentos já escritos
+        } else {
+            memcpy(previous, lengths, sizeof(previous));
+            build_canonical_codes(previous, huff_table);
+        }
+
+        // 4. Bits
+        BitWriter bits = {0, 0};
+        huff_encode_block(data, got, huff_table, &bits, &block);
+        bit_writer_finish(&bits, &block);
+        if (block.error) {
+            ok = 0;
+            break;
+        }
+
+        huff_write_u32(&writer, (uint32_t)got);
+        huff_write_u32(&writer, (uint32_t)block.pos);
+        huff_write_byte(&writer, mode);
+        huff_write_bytes(&writer, block.data, block.pos);
+        total += got;
+    }
+
+    // 5. Fim
+    if (ok) {
+        huff_write_u32(&writer, 0);
+        huff_write_u32(&writer, 0);
+        huff_write_byte(&writer, HUFF_STREAM_END);
+        huff_write_u64(&writer, total);
+    }
+
+    huff_writer_close(&block);
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    free(scratch);
+    return ok;
+}
+
+/*Lê os blocos até o registro de fim, escrevendo em output. packed é o bloco de leitura
+reaproveitado entre os blocos (cresce até o maior bloco visto). block_size é o do
+cabeçalho: bloco maior que isso é registro corrompido. Retorna 1 se deu certo.*/
+int decompress_stream_blocks(HuffReader* reader, HuffWriter* output, HuffDecodeTable* table, size_t block_size,
+                             unsigned char** packed, size_t* packed_capacity) {
+    const unsigned char* data;
+    uint64_t total = 0;
+    int have_table = 0;
+
+    while (1) {
+        // 1. Registro do bloco
+        unsigned char record[HUFF_STREAM_RECORD_SIZE];
+        if (huff_reader_take(reader, sizeof(record), record, &data) != sizeof(record)) return 0;
+
+        uint32_t raw = huff_get_u32(data);
+        uint32_t packed_size = huff_get_u32(data + 4);
+        unsigned char mode = data[8];
+
+        if (mode == HUFF_STREAM_END) {
+            unsigned char size[8];
+            if (huff_reader_take(reader, sizeof(size), size, &data) != sizeof(size)) return 0;
+            return huff_get_u64(data) == total;
+        }
+        if (mode > HUFF_STREAM_STORED || raw > block_size || packed_size > HUFF_STREAM_PACKED_BOUND(raw)) return 0;
+        if (mode == HUFF_STREAM_STORED && packed_size != raw) return 0;
+        if (mode == HUFF_STREAM_REUSE_TABLE && !have_table) return 0;
+
+        // 2. Bloco compactado inteiro
+        if (packed_size > *packed_capacity) {
+            unsigned char* bigger = realloc(*packed, packed_size);
+            if (!bigger) return 0;
+            *packed = bigger;
+            *packed_capacity = packed_size;
+        }
+        if (huff_reader_take(reader, packed_size, *packed, &data) != packed_size) return 0;
+        if (mode == HUFF_STREAM_STORED) {
+            huff_write_bytes(output, data, raw);
+            total += raw;
+            continue;
+        }
+
+        HuffReader block;
+        huff_reader_open_memory(&block, data, packed_size);
+
+        if (mode == HUFF_STREAM_NEW_TABLE) {
+            unsigned char lengths[256];
+            if (!read_code_lengths(&block, lengths) || !build_decode_table_from_lengths(lengths, table)) {
+                huff_reader_close(&block);
+                return 0;
+            }
+            have_table = 1;
+        }
+
+        // 3. Bits → bytes originais
+        uint64_t written = huff_decode_stream(&block, output, table, INT64_MAX, raw);
+        huff_reader_close(&block);
+        if (written != raw) return 0;
+        total += raw;
+    }
+}
+
+// Descompacta um fluxo gerado por compress_stream(), também só para frente. Retorna 1 se deu certo
+int decompress_stream(FILE* input, FILE* output) {
+    HuffReader reader;
+    HuffWriter writer;
+    if (!huff_reader_open(&reader, input, 0)) return 0;
+    if (!huff_writer_open(&writer, output, 0)) {
+        huff_reader_close(&reader);
+        return 0;
+    }
+
+    unsigned char header[HUFF_STREAM_HEADER_SIZE];
+    const unsigned char* data;
+    HuffDecodeTable* table = malloc(sizeof(HuffDecodeTable));
+    unsigned char* packed = NULL;
+    size_t packed_capacity = 0;
+
+    int ok = table && huff_reader_take(&reader, sizeof(header), header, &data) == sizeof(header) &&
+             memcmp(data, HUFF_STREAM_MAGIC, 4) == 0 && data[4] == HUFF_STREAM_VERSION;
+    if (ok) {
+        size_t block_size = ((size_t)data[5] | ((size_t)data[6] << 8) | ((size_t)data[7] << 16)) * 1024;
+        if (block_size == 0) block_size = HUFF_STREAM_BLOCK_SIZE; //fluxo de antes do campo
+        ok = decompress_stream_blocks(&reader, &writer, table, block_size, &packed, &packed_capacity);
+    }
+
+    if (!huff_writer_close(&writer)) ok = 0;
+    huff_reader_close(&reader);
+    free(packed);
+    free(table);
+    return ok;
+}
+
+#endif // HUFF_STREAM_H
@@ -0,0 +1,91 @@
+/*
+    CONSTRUÇÃO DA ÁRVORE EM TEMPO LINEAR (duas filas)
+
+    build_huffman_tree() tira os dois menores da heap e insere o pai de volta:
+    2 remove_lower + 1 insert por nó interno, O(n log n), e um malloc por nó.
+    Nos formatos em pedaços e em fluxo isso é refeito a cada bloco.
+
+    Com as folhas já ordenadas por frequência, dá para fazer sem heap:
+    - fila 1: as folhas, em ordem crescente;
+    - fila 2: os nós internos, na ordem em que são criados.
+    Cada pai criado pesa pelo menos o mesmo que o anterior, então a fila 2
+    também sai ordenada. Os dois menores estão sempre na frente de uma das
+    duas filas: cada passo é só comparar as frentes. O(n) depois da ordenação
+    (radix sort, huff_sort_coins).
+
+    Exemplo: folhas A1 B1 C2 D4
+    fila 1: A1 B1 C2 D4     fila 2: (vazia)
+    pega A1 B1       → cria X2    fila 1: C2 D4   fila 2: X2
+    pega C2 X2       → cria Y4    fila 1: D4      fila 2: Y4
+    pega D4 Y4       → cria raiz  profundidades: D=1, C=2, A=B=3
+
+    Tudo fica em vetores fixos (no máximo 511 nós), nenhum malloc. Só saem os
+    comprimentos dos códigos: os códigos em si são os canônicos.
+*/
+
+#ifndef HUFF_TWO_QUEUE_H
+#define HUFF_TWO_QUEUE_H
+
+#include <stdint.h>
+#include "huff_length_limit.h"
+
+/*Comprimentos de Huffman (sem limite) em lengths[] usando as duas filas.
+Um byte sozinho recebe 1 bit, bytes ausentes ficam com 0. Retorna o maior comprimento.*/
+int huff_two_queue_code_lengths(const uint64_t freq[256], unsigned char lengths[256]) {
+    HuffCoin leaves[256];
+    uint64_t weight[511];  //peso de cada nó interno (posição = ordem de criação)
+    int16_t parent[511];   //0..n-1: folhas (na ordem de leaves), n..2n-2: nós internos
+    int n = 0;
+
+    for (int s = 0; s < 256; s++) {
+        lengths[s] = 0;
+        if (freq[s] > 0) {
+            leaves[n].weight = freq[s];
+            leaves[n].symbol = (int16_t)s;
+            n++;
+        }
+    }
+    if (n == 0) return 0;
+    if (n == 1) {
+        lengths[leaves[0].symbol] = 1;
+        return 1;
+    }
+
+    huff_sort_coins(leaves, n);
+
+    int leaf = 0;          //frente da fila 1
+    int internal = n;      //frente da fila 2
+    int created = n;       //próximo nó interno
+
+    for (; created < 2 * n - 1; created++) {
+        uint64_t sum = 0;
+
+        for (int pick = 0; pick < 2; pick++) {
+            //folha ganha empate: árvores mais rasas
+            if (leaf < n && (internal == created || leaves[leaf].weight <= weight[internal])) {
+                sum += leaves[leaf].weight;
+                parent[leaf++] = (int16_t)created;
+            } else {
+                sum += weight[internal];
+                parent[internal++] = (int16_t)created;
+            }
+        }
+        weight[created] = sum;
+    }
+
+    // Profundidades: o pai sempre tem posição maior que o filho, então basta descer da raiz
+    int root = 2 * n - 2;
+    unsigned char depth[511];
+    int deepest = 0;
+    depth[root] = 0;
+    for (int i = root - 1; i >= 0; i--) {
+        depth[i] = (unsigned char)(depth[parent[i]] + 1);
+        if (i < n) {
+            lengths[leaves[i].symbol] = depth[i];
+            if (depth[i] > deepest) deepest = depth[i];
+        }
+    }
+    return deepest;
+}
+
+#endif // HUFF_TWO_QUEUE_H
@@ -7,11 +7,17 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "pqueue_heap.h"
+#include "huff_profile.h" //medição por etapa, só com -DHUFF_PROFILE
+#include "huff_io.h"
+#include "huff_pool.h"
+#include "huff_histogram.h"
+#include "huff_length_limit.h"
+#include "huff_two_queue.h"
 
 #define BUFFER_SIZE 1024
 
 //Lê o arquivo e conta quantas vezes cada byte aparece, cria nós e insere nas DUAS filas
-void create_huff_queue(FILE *input_file, PRIORITY_QUEUE** pq1, PRIORITY_QUEUE** pq2) {
+void create_huff_queue(FILE *input_file, PRIORITY_QUEUE** pq1, PRIORITY_QUEUE** pq2, NODE_POOL* pool) {
   /*
   FILE *input_file - Onde aponta?
 
@@ -26,62 +32,48 @@ void create_huff_queue(FILE *input_file, PRIORITY_QUEUE** pq1, PRIORITY_QUEUE**
   SÓ MUDA A CÓPIA LOCAL!
   */
 
-    int freq[256] = {0}; //array para salvar as frequencias de bytes que aparece no arquivo lido, inicializa TODOS os elementos com ZERO evitando lixo de memória e contagens erradas.
+    HUFF_PROFILE_BEGIN(profile);
+    uint64_t total = 0; //bytes lidos (para a medição por etapa)
+    uint64_t freq[256] = {0}; //array para salvar as frequencias de bytes que aparece no arquivo lido, inicializa TODOS os elementos com ZERO evitando lixo de memória e contagens erradas.
     //Pq tamanho 256? Pq o unsigned char vai de 0 a 255 → 256 valores
+    //Pq uint64_t? Com int, um arquivo com mais de 2 GiB do mesmo byte estoura o contador
 
-    unsigned char c; 
-    /*Pq usar um "caractere sem sinal"?
-    
-    O char "normal":
-    char c;  Pode ser -128 a 127 (COM sinal)
-    Se ler byte 255 → vira -1 → freq[-1] ← ACESSO INVÁLIDO, fora do intervalo 0 - 255 de freq, tenta acessar uma memoria ANTES do inicio do array
+    //Conta a frequencia de caracteres
+    HuffReader reader;
+    if (!huff_reader_open_mapped(&reader, input_file)) return; //arquivo grande: mapeado na memória, senão lê em blocos
 
-    Com o unsigned char:
-    unsigned char c; SEMPRE 0 a 255 (SEM sinal)
-    Qualquer byte lido fica entre 0-255 → freq[c] sempre válido 
-    */
+    HuffPool* threads = NULL;
+    if (reader.map && reader.map_size >= HUFF_HIST_PARALLEL_MIN) {
+        threads = huff_pool_create(0); //arquivo grande e mapeado: cada núcleo conta um pedaço
+    }
 
-    //Conta a frequencia de caracteres
-    while (fread(&c, 1, 1, input_file) == 1) { 
-      
-      /* Função fread(&c <- Onde guardar (endereço de c), 1 <- Tamanho de CADA elemento (1 byte), 1 <- Quantos elementos ler (1 elemento), input_file <- Arquivo de onde ler)
+    while (huff_reader_refill(&reader) > 0) { 
+      /* huff_reader_refill(&reader) entrega o próximo pedaço do arquivo em reader.data[0 .. reader.len-1]:
+      um bloco de 64 KiB lido com fread ou, com mmap, o arquivo inteiro de uma vez (sem cópia)
       
-      Condição: == 1) <- Enquanto conseguir ler 1 elemento
-      Retorna 1: Leu 1 elemento com sucesso → continua
+      Retorna > 0: quantos bytes vieram nesse bloco → continua
       Retorna 0: Fim do arquivo ou erro → para
-      */
 
-        freq[c]++; /*quando um caracter é mandado como indice, esse caracter é transformado em decimal da tabela ASCII, assim toda vez que chega o mesmo caracter é incrementado um na posição correspondente
-        
-        Exemplo:
-        Quando leio byte 65 ('A'):
-        freq[65]++  → Incrementa a posição 65 do array
-        
-        Quando leio byte 66 ('B'):  
-        freq[66]++  → Incrementa a posição 66
-        
-        Quando leio byte 65 ('A') de novo:
-        freq[65]++  → Agora freq[65] = 2
-        
-        Assim:
-        freq[65] = 2  // 'A' apareceu 2 vezes
-        freq[66] = 1  // 'B' apareceu 1 vez
-        freq[67] = 0  // 'C' nunca apareceu
-        ...etc
-        */
+      Antes era fread(&c, 1, 1, ...) → uma chamada da libc para CADA byte do arquivo
+      */
 
+        count_frequencies_parallel(reader.data, reader.len, freq, threads); //freq[c]++ para cada byte, ver huff_histogram.h
+        total += reader.len;
     }
 
+    huff_pool_destroy(threads);
+    huff_reader_close(&reader);
+
     // Cria nós para caracteres com frequência diferente de zero e os insere em ambas as filas
       for (int i = 0; i < 256; i++) {
           if (freq[i] > 0) { //enquanto a frequencia for maior que zero, continua .
-              NODE* node = create_node(i, freq[i], NULL, NULL); /*Cria um ponteiro do tipo node que nele vai ter a frequencia, e seus filhos apontam pra nulo. Essa função está em pqueue_heap.h
+              NODE* node = create_node(pool, i, freq[i], NULL, NULL); /*Cria um ponteiro do tipo node que nele vai ter a frequencia, e seus filhos apontam pra nulo. Essa função está em pqueue_heap.h
 
               // Exemplo: i=65, freq[65]=2
-              NODE* node = create_node(65, 2, NULL, NULL);
+              NODE* node = create_node(pool, 65, 2, NULL, NULL);
               
               // Dentro de create_node (Em pqueue_heap.h):
-              NODE* node = (NODE*)malloc(sizeof(NODE));
+              NODE* node = &pool->nodes[pool->used++];  // próximo nó livre do pool, sem malloc
               node->character = 65;     // Byte 'A'
               node->frequency = 2;      // Apareceu 2 vezes  
               node->left = NULL;        // Ainda não tem filhos
@@ -92,25 +84,44 @@ void create_huff_queue(FILE *input_file, PRIORITY_QUEUE** pq1, PRIORITY_QUEUE**
               insert(*pq2, node); //insere esse nó na fila de prioridade 2 (heap 2)
           }
       }
+    HUFF_PROFILE_END(profile, HUFF_STAGE_HISTOGRAM, total);
+    (void)total;
 }
 
 // Constrói a árvore de Huffman a partir da fila de prioridade
-NODE* build_huffman_tree(PRIORITY_QUEUE* pq) {
+NODE* build_huffman_tree(PRIORITY_QUEUE* pq, NODE_POOL* pool) {
+    HUFF_PROFILE_BEGIN(profile);
     while (pq->size > 1) { //enquanto o tamanho da minha heap for > 1  continuo 
         NODE* left = remove_lower(pq); // removo o menor nó da heap e esse sera o no filho a esquerda 
         NODE* right = remove_lower(pq); // removo o  segundo menor nó da heap e esse sera o no filho a direita 
 
         // Create a parent node with the left and right children
-        NODE* parent = create_node('\0', left->frequency + right->frequency, left, right); /*cria um no "pai" com caracter "nulo" , sua freq sera a soma das duas menores frequencias dos respectivos no removido acima.
+        NODE* parent = create_node(pool, '\0', left->frequency + right->frequency, left, right); /*cria um no "pai" com caracter "nulo" , sua freq sera a soma das duas menores frequencias dos respectivos no removido acima.
         Seus filhos será o nó com menor freq e o de segunda menor freq*/
 
         insert(pq, parent); //Insere o novo nó pai na fila de prioridade (heap) agora com sua frequencia sendo a soma das frequencia dos filhos (isso mudará sua posição na heap)
     }
 
     //O ultimo nó que sobra é a raiz da arvore de huffman
+    HUFF_PROFILE_END(profile, HUFF_STAGE_TREE, 0);
     return remove_lower(pq); //Agora o size é = 1 , significa o ultimo nó, o nó pai com menor frequencia, retornamos ele para ser usado na proxima etapa - criação da tabela de codigo.
 }
 
+// Monta a árvore direto de um vetor de frequências, sem ler arquivo (os nós saem de pool)
+NODE* build_tree_from_frequencies(const uint64_t freq[256], NODE_POOL* pool) {
+    PRIORITY_QUEUE* pq = create_queue();
+
+    for (int i = 0; i < 256; i++) {
+        if (freq[i] > 0) {
+            insert(pq, create_node(pool, i, freq[i], NULL, NULL));
+        }
+    }
+
+    NODE* root = build_huffman_tree(pq, pool); //NULL se não havia nenhum byte
+    free(pq); //a fila ficou vazia, os nós agora pertencem à árvore
+    return root;
+}
+
 // Define a estrutura da tabela de Huffman com os códigos binários dos caracteres
 typedef struct {
     uint32_t code; 
@@ -181,8 +192,8 @@ void create_huffman_table(NODE* root, uint32_t code, int depth, HuffmanCode huff
 }
 
 //Calcula quantos bits totais serão escritos no corpo compactado
-int calculate_bits_trashed(PRIORITY_QUEUE* pq, HuffmanCode huff_table[256]) {
-    int bit_amount = 0; //quantidade de bit
+uint64_t calculate_bits_trashed(PRIORITY_QUEUE* pq, HuffmanCode huff_table[256]) {
+    uint64_t bit_amount = 0; //quantidade de bit (64 bits: com int, passava de 2^31 bits com uns 256 MiB de entrada)
     //vai removendo nó a nó e multiplicando a frequencia de caracter no arquivo pela quantidade de bit mais significativo (quantas vezes se repete)
     while (pq->size > 0) {
         NODE* node = remove_lower(pq); 
@@ -204,6 +215,23 @@ int calculate_bits_trashed(PRIORITY_QUEUE* pq, HuffmanCode huff_table[256]) {
     return bit_amount; //retorna a quantidade de bit
 }
 
+/*Igual a calculate_bits_trashed(), mas sem esvaziar a fila (percorre as folhas da árvore):
+dá para saber o tamanho dos dados compactados ANTES de escrever o cabeçalho.*/
+uint64_t tree_coded_bits(NODE* node, HuffmanCode huff_table[256]) {
+    if (!node) return 0;
+    if (!node->left && !node->right) return node->frequency * huff_table[node->character].length;
+    return tree_coded_bits(node->left, huff_table) + tree_coded_bits(node->right, huff_table);
+}
+
+/*Quantos bytes write_tree() escreve: '0' por nó interno, '1' + o byte por folha,
+e uma barra invertida a mais nas folhas de '*' e da própria barra (o escape).
+count_tree_size() conta nós, não bytes: para o tamanho do cabeçalho, use esta.*/
+uint64_t tree_serialized_size(NODE* node) {
+    if (!node) return 0;
+    if (!node->left && !node->right) return node->character == '*' || node->character == '\\' ? 3 : 2;
+    return 1 + tree_serialized_size(node->left) + tree_serialized_size(node->right);
+}
+
 // Conta o número de nós da árvore (para o tamanho da árvore no cabeçalho)
 int count_tree_size(NODE* root) {
     if (!root) return 0; //checa se o nó é vazio
@@ -239,14 +267,14 @@ int is_leaf(NODE* node) {
 } 
 
 // Escreve a árvore de Huffman no arquivo de saída em PRE ORDEM = Raiz → Esquerda → Direita 
-void write_tree(NODE* root, FILE* output_file) {
+void write_tree(NODE* root, HuffWriter* output) {
   if (is_leaf(root)) { //verifica se é folha (nao tem filhos)
     //Nó folha foi encontrado
-    fputc('1', output_file); // Marca folha
-    //fputc: Escreve UM caractere em um arquivo, sendo '1' caracter a ser escrito e output_file o arquivo onde escrever
+    huff_write_byte(output, '1'); // Marca folha
+    //huff_write_byte: Escreve UM caractere no bloco de escrita (ver huff_io.h), sendo '1' caracter a ser escrito
   
-    if (root->character == '*' || root->character == '\\') { //se o caracter lido foi * ou \\ 
-      fputc('\\', output_file);
+    if (root->character == '*' || root->character == '\\') { //se o caracter lido foi * ou barra invertida
+      huff_write_byte(output, '\\');
       /*
       Caractere * → escreve \*
       Caractere \ → escreve \\
@@ -254,169 +282,184 @@ void write_tree(NODE* root, FILE* output_file) {
       Na descompactação: \ significa "o próximo caractere é literal"
       */
     }
-    fputc(root->character, output_file); //escreve o caracter no arquivo de saida 
+    huff_write_byte(output, root->character); //escreve o caracter no arquivo de saida 
     // FOLHA: escreve e PARA (sem recursão)
     // Porque folhas não têm filhos para visitar!
 
   } else {
     //Nao é um nó folha, é um nó interno 
-    fputc('0', output_file); 
+    huff_write_byte(output, '0'); 
     // NÓ INTERNO: escreve marcação E continua recursão
     // Porque precisa visitar os filhos!
-    write_tree(root->left, output_file); //chamada recursiva para o filho a esquerda 
-    write_tree(root->right, output_file);  //chamada recursiva para o filho a direita 
+    write_tree(root->left, output); //chamada recursiva para o filho a esquerda 
+    write_tree(root->right, output);  //chamada recursiva para o filho a direita 
   }
 }
 
-// Escreve o cabeçalho no novo arquivo (lixo, tamanho da árvore, árvore)
-// Escreve a árvore de Huffman codificada no cabeçalho do arquivo compactado, bit a bit
-void write_header(PRIORITY_QUEUE* pq, HuffmanCode huff_table[256], FILE *output_file, NODE* root) {
+/*
+    CABEÇALHO COM TAMANHO DE 64 BITS ("HUFT")
 
-    int total_bits = calculate_bits_trashed(pq, huff_table); //Calcula o total de bits que serão usados para escrever os dados compactados. 
-    int trash = ((8 - (total_bits % 8)) % 8); //Calcula quantos bits finais do último byte vão ser "lixo"
-    // Se sobrar, digamos, 5 bits, precisamos preencher 3 bits com 0s → então trash = 3.
-    /*
-    1. total_bits % 8 = 13 % 8 = 5
-   → Precisamos de 5 bits no último byte
-   
-   2. 8 - 5 = 3  
-      → Faltam 3 bits para completar o byte
-   
-   3. (8 - 5) % 8 = 3 % 8 = 3
-      → trash = 3 bits de preenchimento*/
-
-    int tree_size = count_tree_size(root);//Tamanho da árvore de Huffman (em bytes): necessário para a descompactação.
-
-    /*O cabeçalho tem 16 bits com a seguinte estrutura:
-    [3 bits de lixo][13 bits de tamanho da árvore]*/
-    unsigned short header = (trash << 13) | tree_size; //short = Tipo de dado menor que int (normalmente 16 bits)
-    /*Exemplo: trash=3, tree_size=25
-    trash = 3      <- binário: 011
-    tree_size = 25 <- binário: 0000000011001
-    
-    (trash << 13) = 0110000000000000  // Lixo nos 3 primeiros bits
-    tree_size     = 0000000000011001  // Tamanho nos 13 últimos
-    
-    (trash << 13) | tree_size = 0110000000011001  // Junta tudo!
-    */
+    O cabeçalho antigo tinha 2 bytes: [3 bits de lixo][13 bits de tamanho da árvore].
+    O descompactador só sabia onde os dados acabavam pelo tamanho do arquivo
+    (ftell, um long) menos o lixo, e o total de bits era somado num int, que
+    estoura com uns 256 MiB de entrada.
 
-    //Precisamos escrever 2 bytes no arquivo, não 16 bits direto. Por isso separamos em dois:
-    unsigned char byte1 = header >> 8; // pega os 8 a esquerda, Shift Right (deslocamento para direita)
-    /*header:    01100000 00011001
-      >> 8:      00000000 01100000  ← byte1 agora está na posição certa*/
+    A revisão guarda o tamanho original em 64 bits; o lixo não é mais gravado
+    (o último byte continua completado com zeros, mas o descompactador para
+    quando escreve o tamanho original):
 
-    unsigned char byte2 = header & 0xFF; // pega os 8 a direita 
-    /* header & 0xFF - AND bit a bit
+    [4 bytes]  "HUFT"
+    [1 byte]   versão
+    [8 bytes]  tamanho original (u64, little-endian)
+    [...]      árvore em pré-ordem (write_tree, igual ao formato antigo)
+    [...]      bits (compactor)
 
-    O que acontece:
-    
-    header: 01100000 00011001
-    & 0xFF: 00000000 11111111
-    result: 00000000 00011001  ← Só passa os 8 bits da direita
-    byte2 = 00011001 = 25
-    */
+    Arquivos com o cabeçalho antigo de 2 bytes continuam sendo descompactados
+    (read_header).
+*/
 
-    //os dois bytes lidos acima serão os primeiros dois bytes do arquivo compactado
-    fwrite(&byte1, 1, 1, output_file); //fwrite: Escrever dados em binários
-    fwrite(&byte2, 1, 1, output_file); 
+#define HUFF_TREE_MAGIC "HUFT"
+#define HUFF_TREE_VERSION 1
+#define HUFF_TREE_HEADER_SIZE 13 //magic + versão + tamanho original
+#define HUFF_SIZE_UNKNOWN UINT64_MAX //.huff antigo: o tamanho original não está no arquivo
 
-    /*fwrite(&byte1,    // Onde estão os dados (endereço de byte1)
-       1,         // Tamanho de CADA elemento (1 byte)
-       1,         // Quantos elementos escrever (1 elemento)
-       output_file) // Arquivo onde escrever
-    */
+// Escreve o cabeçalho no novo arquivo (tamanho original, árvore)
+/*pq e huff_table não são mais usados (o lixo não é gravado): ficam para não mudar quem chama.
+O tamanho original é a frequência da raiz, a soma de todas as folhas.*/
+void write_header(PRIORITY_QUEUE* pq, HuffmanCode huff_table[256], FILE *output_file, NODE* root) {
+    HUFF_PROFILE_BEGIN(profile);
+    (void)pq;
+    (void)huff_table;
+
+    uint64_t original_size = root ? root->frequency : 0;
 
-    write_tree(root, output_file); //Depois de escrever os dois bytes agora chama write_tree para escrever a arvore em PRE ORDEM 
+    HuffWriter writer; //cabeçalho e árvore passam pelo bloco de escrita (ver huff_io.h)
+    if (!huff_writer_open(&writer, output_file, 0)) return;
+
+    huff_write_bytes(&writer, (const unsigned char*)HUFF_TREE_MAGIC, 4);
+    huff_write_byte(&writer, HUFF_TREE_VERSION);
+    huff_write_u64(&writer, original_size);
+
+    if (root) write_tree(root, &writer); //Depois do tamanho chama write_tree para escrever a arvore em PRE ORDEM
+
+    if (!huff_writer_close(&writer)) { //manda tudo para o arquivo ANTES do compactor() escrever os dados
+        perror("Erro ao escrever o cabeçalho");
+    }
+    HUFF_PROFILE_END(profile, HUFF_STAGE_HEADER, 0);
 }
 
-// Estrutura para armazenar bits até completar um byte
-//vai acumulando bits um a um até formar um byte completo (8 bits)
-//É para a COMPACTAÇÃO dos DADOS do arquivo original
-typedef struct {
-    unsigned char byte;
-    int bits_used;
-} BitBuffer;
+// Acumulador de bits de 64 bits para a COMPACTAÇÃO dos DADOS do arquivo original
+/*Em vez de colocar bit a bit num unsigned char e testar "encheu 8?" a cada bit,
+o código Huffman inteiro entra no acumulador com UM shift e UM OR:
 
-// adiciona um novo bit ao buffer.
-void bit_buffer_add(BitBuffer *bit_buffer, int bit) {
-    bit_buffer->byte <<= 1; /*Move todos os bits atuais do buffer uma posição à esquerda.
-Isso abre espaço no final (bit menos significativo) para o novo bit. -> 00000001 -> 00000010*/
+    acc = (acc << length) | code;
 
-    bit_buffer->byte |= (bit & 1); //OR bit a bit com o novo bit, garantindo que ele entre no final.
-    /*(bit & 1):
-    Isso isola apenas o bit menos significativo (o último) do valor bit.
-    Se bit = 0, então 0 & 1 = 0.*/
-    //depois faz um OR 
+Quando juntam 32 bits ou mais, os 32 mais antigos saem de uma vez (4 bytes).
+Como cada código tem no máximo 32 bits (uint32_t) e sobram no máximo 31 bits
+pendentes, 31 + 32 = 63 bits sempre cabem no uint64_t.
 
-    bit_buffer->bits_used++; //Aumenta o contador de bits já utilizados no byte.
+A ordem dos bits no arquivo é a mesma de antes (do mais significativo pro menos),
+então o .huff gerado é idêntico ao da versão bit a bit.*/
+typedef struct {
+    uint64_t acc;  //bits pendentes, alinhados à direita (o último bit colocado é o bit 0)
+    int count;     //quantos bits de acc ainda não foram escritos
+} BitWriter;
+
+// Coloca um código inteiro no acumulador e escreve 4 bytes quando junta 32 bits
+static inline void bit_writer_put(BitWriter* bits, HuffWriter* out, uint32_t code, int length) {
+    bits->acc = (bits->acc << length) | code;
+    bits->count += length;
+
+    if (bits->count >= 32) {
+        bits->count -= 32;
+        uint32_t word = (uint32_t)(bits->acc >> bits->count); //os 32 bits mais antigos
+
+        if (out->capacity - out->pos >= 4) { //caminho rápido: cabe direto no bloco de escrita
+            unsigned char* p = out->data + out->pos;
+            p[0] = (unsigned char)(word >> 24);
+            p[1] = (unsigned char)(word >> 16);
+            p[2] = (unsigned char)(word >> 8);
+            p[3] = (unsigned char)word;
+            out->pos += 4;
+        } else {
+            huff_write_byte(out, (unsigned char)(word >> 24));
+            huff_write_byte(out, (unsigned char)(word >> 16));
+            huff_write_byte(out, (unsigned char)(word >> 8));
+            huff_write_byte(out, (unsigned char)word);
+        }
+    }
 }
 
-//Escreve o conteúdo parcial do BitBuffer no arquivo, preenchendo com zeros os bits restantes até formar 8 bits.
-void write_buffer(FILE *f, BitBuffer *bit_buffer) { 
-    if (bit_buffer->bits_used == 0) return;//Se o buffer estiver vazio, não há nada para escrever.
+// Escreve o que sobrou no acumulador; o último byte incompleto é completado com zeros (o "lixo")
+void bit_writer_finish(BitWriter* bits, HuffWriter* out) {
+    while (bits->count >= 8) {
+        bits->count -= 8;
+        huff_write_byte(out, (unsigned char)(bits->acc >> bits->count));
+    }
 
-    //caso em que o byte nao tem 8 bits 
-    unsigned char temp_byte = bit_buffer->byte << (8 - bit_buffer->bits_used); //ele move os bits usados para a esquerda, para “encostar” os bits no início do byte.
-    /*bit_buffer->byte = 000101 (apenas 5 bits usados).
-    bit_buffer->bits_used = 5
+    if (bits->count > 0) {
+        /*bits->acc = ...00101 (apenas 5 bits pendentes)
+        O deslocamento será 8 - 5 = 3 → 00101000
+        Os bits válidos ficam na parte mais significativa do byte e o lixo na menos significativa.*/
+        huff_write_byte(out, (unsigned char)(bits->acc << (8 - bits->count)));
+    }
 
-O deslocamento será 8 - 5 = 3
-    Resultado: 000101 << 3 = 101000 → os bits ocupam a parte mais significativa do byte.
-    Isso garante que a estrutura do cabeçalho fique correta, pois o "lixo" (bits não usados) está na parte menos significativa.*/
+    bits->acc = 0;
+    bits->count = 0;
+}
 
-    fwrite(&temp_byte, 1, 1, f); //fwrite : escreve 1 byte no arquivo.
-    //usa a variável temporária temp_byte, que contém o conteúdo alinhado.
+//O laço fica numa função separada para a medição (huff_profile.h) não atrapalhar a otimização dele
+static inline void huff_encode_bytes(const unsigned char* data, size_t n, const HuffmanCode huff_table[256], BitWriter* bits, HuffWriter* out) {
+    for (size_t i = 0; i < n; i++) {
+        HuffmanCode code = huff_table[data[i]];
+        bit_writer_put(bits, out, code.code, code.length);
+    }
+}
 
-    //zera para a proxima vez que chamar 
-    bit_buffer->byte = 0;   
-    bit_buffer->bits_used = 0;
+// Núcleo do compactador: codifica n bytes já em memória (um bloco lido, um pedaço do arquivo...)
+void huff_encode_block(const unsigned char* data, size_t n, const HuffmanCode huff_table[256], BitWriter* bits, HuffWriter* out) {
+    HUFF_PROFILE_BEGIN(profile);
+    huff_encode_bytes(data, n, huff_table, bits, out);
+    HUFF_PROFILE_END(profile, HUFF_STAGE_ENCODE_BLOCK, n);
 }
 
 // Escreve os dados compactados no novo arquivo
 void compactor(FILE *input_file, FILE *output_file, HuffmanCode huff_table[256]) {
-    unsigned char c;
-    BitBuffer bit_buffer = {0, 0}; //Inicializa bit_buffer
-
-    // Lê cada caractere do arquivo de entrada
-    while (fread(&c, 1, 1, input_file) == 1) {
-        // 1. Pega o código Huffman desse byte
-        HuffmanCode code = huff_table[c];
-
-        // 2. Adiciona cada bit do código Huffman ao buffer (do mais significativo pro menos)
-        for (int i = code.length - 1; i >= 0; i--) {
-        // Pega o bit MAIS SIGNIFICATIVO primeiro
-        // e vai até o bit MENOS SIGNIFICATIVO
-
-        /*Exemplo Prático:
-        Se temos um código Huffman:
-        
-        code.code = 5 (binário: 101)
-        code.length = 3 (3 bits)
-        
-        O loop vai:
-        i = 2: pega o bit na posição 2 (mais à esquerda)
-        i = 1: pega o bit na posição 1  
-        i = 0: pega o bit na posição 0 (mais à direita)
-        */
-
-            // 3. Pega o bit atual: (code.code >> i) & 1
-            bit_buffer_add(&bit_buffer, (code.code >> i) & 1);
-            
-            // 4. Se buffer cheio, escreve byte(8 bits)
-            if (bit_buffer.bits_used == 8) { 
-                write_buffer(output_file, &bit_buffer);
-            }
-        }
+    HUFF_PROFILE_BEGIN(profile);
+    BitWriter bits = {0, 0}; //Inicializa o acumulador vazio
+    uint64_t total = 0; //bytes de entrada (para a medição por etapa)
+
+    HuffReader reader;
+    HuffWriter writer;
+    if (!huff_reader_open_mapped(&reader, input_file)) return;
+    if (!huff_writer_open(&writer, output_file, 0)) {
+        huff_reader_close(&reader);
+        return;
+    }
+
+    // 1. Lê o arquivo de entrada em blocos ou pelo mapeamento (ver huff_io.h)
+    while (huff_reader_refill(&reader) > 0) {
+        // 2. Cada byte vira seu código Huffman, que entra inteiro no acumulador
+        huff_encode_block(reader.data, reader.len, huff_table, &bits, &writer);
+        total += reader.len;
     }
 
-    // 5. Escreve bits que sobraram (último byte incompleto)
-    write_buffer(output_file, &bit_buffer);
+    // 3. Escreve bits que sobraram (último byte incompleto)
+    bit_writer_finish(&bits, &writer);
+
+    // 4. Manda para o arquivo o que ainda está no bloco de escrita
+    if (!huff_writer_close(&writer)) {
+        perror("Erro ao escrever o arquivo compactado");
+    }
+    huff_reader_close(&reader);
+    HUFF_PROFILE_END(profile, HUFF_STAGE_COMPACTOR, total);
+    (void)total;
 }
 
 /*
 // 1. PRIMEIRO: Prepara tudo
-create_huff_queue(original_file, &huff_queue1, &huff_queue2);
-NODE* root = build_huffman_tree(huff_queue1);
+create_huff_queue(original_file, &huff_queue1, &huff_queue2, pool);
+NODE* root = build_huffman_tree(huff_queue1, pool);
 create_huffman_table(root, code, 0, huff_table);
 
 // 2. DEPOIS: Escreve cabeçalho + árvore
@@ -427,21 +470,22 @@ rewind(original_file);  // Volta ao início do arquivo
 compactor(original_file, new_file, huff_table);  // ← AQUI!
 */
 
-void free_huffman_tree(NODE* root) {
-    if (root == NULL) return;
-
-    free_huffman_tree(root->left);
-    free_huffman_tree(root->right);
-    free(root);
-}
-
-
-
 /*
     FUNÇÕES PARA DESCOMPACTAR O ARQUIVO
 */
 
-// Lê os dois primeiros bytes do cabeçalho e extrai lixo e tamanho da árvore
+/*Lê o cabeçalho "HUFT" (magic, versão, tamanho original), deixando o arquivo no começo da árvore.
+Retorna 0 se não for esse cabeçalho.*/
+int read_header_64(FILE *file, uint64_t *original_size) {
+    unsigned char header[HUFF_TREE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) return 0;
+    if (memcmp(header, HUFF_TREE_MAGIC, 4) != 0 || header[4] != HUFF_TREE_VERSION) return 0;
+
+    *original_size = huff_get_u64(header + 5);
+    return 1;
+}
+
+// .huff antigo: lê os dois primeiros bytes do cabeçalho e extrai lixo e tamanho da árvore
 void read_header(FILE *file, int *trash, int *tree_size) { //recebe o ponteiro para o arquivo , o tamanho do lixo , e o tamanho da arvore 
     unsigned char byte1, byte2;
     //Lê os dois primeiros bytes do arquivo:
@@ -470,27 +514,34 @@ void read_header(FILE *file, int *trash, int *tree_size) { //recebe o ponteiro p
 }
 
 // Lê a árvore codificada no arquivo compactado e reconstrói a árvore de Huffman a partir da representação em pré-ordem que está gravada no arquivo logo após os 2 bytes do cabeçalho.
-NODE* read_tree(FILE *file, int *bytes_read) { 
+NODE* read_tree(HuffReader *file, int *bytes_read, NODE_POOL* pool) { 
+    //Uma árvore válida tem no máximo 256 folhas de até 3 bytes + 255 nós internos: mais que isso é arquivo corrompido
+    if (*bytes_read >= 3 * MAX_HEAP + MAX_HEAP - 1) return NULL;
+
     // c sera 1 ou 0 (tipo do NO)
-    int c= fgetc(file);//fgetc : ler um único caractere de um arquivo
+    int c= huff_read_byte(file);//huff_read_byte : ler um único caractere (igual fgetc, mas pelo bloco de leitura)
     (*bytes_read)++; //conta quantos bytes da árvore já foram lidos
 
     if (c == '1') { //Se for '1': é uma folha (chegamos a um caracter da arvore)
-        int next = fgetc(file);  //Ler o proximo caracter do arquivo 
+        int next = huff_read_byte(file);  //Ler o proximo caracter do arquivo 
         (*bytes_read)++; //Conta +1 byte lido 
 
         if (next == '\\') { //Considerando o caso em que o caracter de "escape"
-            next = fgetc(file);
+            next = huff_read_byte(file);
             (*bytes_read)++;
         }
 
-        return create_node((unsigned char)next, 0, NULL, NULL); //Cria o nó, nosso caracter 
+        if (next == EOF) return NULL; //arquivo acabou no meio da folha
+
+        return create_node(pool, (unsigned char)next, 0, NULL, NULL); //Cria o nó, nosso caracter (NULL se o pool encheu)
 
     } else if (c == '0') { //Se for '0': é um nó interno ( um no com nada que aponta pro filhos)
         //chamada recurssiva para filhos 
-        NODE *left = read_tree(file, bytes_read); // chama filho pra esquerda 
-        NODE *right = read_tree(file, bytes_read); // chama filho para direita 
-        return create_node('\0', 0, left, right); // cria no interno 
+        NODE *left = read_tree(file, bytes_read, pool); // chama filho pra esquerda 
+        NODE *right = read_tree(file, bytes_read, pool); // chama filho para direita 
+
+        if (!left || !right) return NULL; //um dos lados veio corrompido (os nós já criados saem junto com o pool)
+        return create_node(pool, '\0', 0, left, right); // cria no interno 
     }
 
     return NULL; //quando fgetc nao retorna um caracter (evita dados invalidos)
@@ -507,72 +558,711 @@ NODE* read_tree(FILE *file, int *bytes_read) {
     */
 }
 
-// Percorre os bits do corpo compactado e escreve os caracteres no arquivo de saída
-void decompress(FILE *input, FILE *output, NODE* root, int trash_size, int header_bytes) {
-    // input: arquivo compactado (.huff) para ler
-    // output: arquivo descompactado para escrever  
-    // root: raiz da árvore de Huffman reconstruída
-    // trash_size: quantos bits ignorar no último byte (0-7)
-    // header_bytes: quantos bytes pular (cabeçalho + árvore)
+/*
+    DECODIFICAÇÃO POR TABELA
+
+    Andar na árvore bit a bit custa um desvio (esquerda/direita) por bit lido.
+    Em vez disso, montamos uma tabela com 2^HUFF_LOOKUP_BITS entradas: o índice é
+    a "janela" com os próximos HUFF_LOOKUP_BITS bits do arquivo e a entrada diz qual
+    byte esses bits formam e quantos bits o código realmente usa.
+
+    Exemplo com janela de 3 bits e a árvore  A(0)  B(10)  R(11):
+    índice 000..011 → A, 1 bit     (todo padrão que começa com 0 é A)
+    índice 100..101 → B, 2 bits
+    índice 110..111 → R, 2 bits
+
+    Códigos maiores que a janela (árvores muito desbalanceadas) ficam com
+    length = 0 na tabela e vão para o caminho lento, decode_long_code():
+    - tabela montada da árvore: continua pela árvore a partir do nó interno
+      alcançado depois de HUFF_LOOKUP_BITS bits;
+    - tabela montada dos comprimentos (códigos canônicos): compara com o
+      primeiro código de cada comprimento, sem árvore nenhuma.
+*/
 
-    fseek(input, 0, SEEK_END); // Vai para o FINAL do arquivo
-    //fseek(arquivo, posição, origem -> SEEK_END = final do arquivo); 
-    //fseek : Move o "cursor" de leitura/escrita dentro do arquivo, como se você escolhesse onde começar a ler ou escrever
-    long file_size = ftell(input); // Pega quantos bytes tem o arquivo
-    //ftell : Retorna a posição atual do cursor (em bytes a partir do início do arquivo). É um jeito de descobrir o tamanho total do arquivo.
-    long data_size = file_size - header_bytes; // Calcula tamanho dos dados
-    //data_size = tamanho do arquivo - tamanho do cabeçalho 
-    fseek(input, header_bytes, SEEK_SET); // Volta para INÍCIO dos dados
-     // Vai para header_bytes depois do INÍCIO -> SEEK_SET = início do arquivo
-
-    NODE* current = root; // Começa na raiz da árvore
-    unsigned char byte; //Começa a ler byte a byte da parte compactada.
-
-    for (long i = 0; i < data_size; i++) { //cada byte nos dados
-        fread(&byte, 1, 1, input);//ler o byte atual
-        /* Função fread(&byte <- Onde guardar (endereço de byte), 1 <- Tamanho de CADA elemento (1 byte), 1 <- Quantos elementos ler (1 elemento), input <- Arquivo de onde ler)*/
-        
-
-        for (int bit = 7; bit >= 0; bit--) { //cada bit no byte (do mais pro menos significativo)
-
-            int current_bit = (byte >> bit) & 1; // bit_atual = shift rigth do byte, bit vezes, e seta ele fazendo um AND 1
-
-            /*Exemplo:
-            byte = 173 (10101101):
-
-            bit=7: 10101101 >> 7 = 00000001 & 1 = 1
-            bit=6: 10101101 >> 6 = 00000010 & 1 = 0  
-            bit=5: 10101101 >> 5 = 00000101 & 1 = 1
-            bit=4: 10101101 >> 4 = 00001010 & 1 = 0
-            bit=3: 10101101 >> 3 = 00010101 & 1 = 1
-            bit=2: 10101101 >> 2 = 00101011 & 1 = 1
-            bit=1: 10101101 >> 1 = 01010110 & 1 = 0
-            bit=0: 10101101 >> 0 = 10101101 & 1 = 1
-
-            Resultado: 1 0 1 0 1 1 0 1 (exatamente os bits do byte!) 
-            
-            Assim cada bit é analisado, um de cada vez.
-            */
-
-            if (current_bit == 0) // para cada bit , vai ser 0 para o filho a esquerda 
-                current = current->left;
-            else
-                current = current->right; // 1 para o filho a direita 
-
-            if (is_leaf(current)) { //checa se chegamos numa folha (se chegou numa folha )
-                // (caracter a ser escrito, ponteiro para o arquivo)
-                fputc(current->character, output); //fputc : escreve um único caractere em um arquivo (escreve o caractere no arquivo de saída.)
-                current = root; //Reinicia o ponteiro na raiz da árvore para continuar.
+#define HUFF_LOOKUP_BITS 11 // 2^11 = 2048 entradas de 2 bytes = 4 KiB, cabe na cache L1
+#define HUFF_MAX_CODE_BITS 32 // HuffmanCode.code é uint32_t
+
+typedef struct {
+    unsigned char symbol; // byte decodificado
+    unsigned char length; // quantos bits o código usa (0 = código maior que a janela)
+} HuffLookupEntry;
+
+typedef struct {
+    HuffLookupEntry entries[1 << HUFF_LOOKUP_BITS];
+    int canonical;        // 1 = montada dos comprimentos, 0 = montada da árvore
+
+    // Códigos longos, tabela da árvore: nó interno alcançado depois da janela
+    NODE* long_nodes[1 << HUFF_LOOKUP_BITS];
+
+    // Códigos longos, tabela canônica (o índice é o comprimento do código)
+    int max_length;
+    uint32_t first_code[HUFF_MAX_CODE_BITS + 1];   // menor código com esse comprimento
+    uint32_t count[HUFF_MAX_CODE_BITS + 1];        // quantos códigos têm esse comprimento
+    uint32_t first_index[HUFF_MAX_CODE_BITS + 1];  // onde eles começam em symbols[]
+    unsigned char symbols[256];                     // bytes ordenados por (comprimento, byte)
+
+    int single_symbol;    // árvore de uma folha só: o byte que se repete (-1 se não for o caso)
+} HuffDecodeTable;
+
+// Preenche a tabela percorrendo a árvore uma única vez (pré-ordem, igual write_tree)
+void fill_decode_table(NODE* node, uint32_t code, int depth, HuffDecodeTable* table) {
+    if (!node) return;
+
+    if (is_leaf(node) || depth == HUFF_LOOKUP_BITS) {
+        //todos os índices que começam com "code" levam a esse nó
+        int free_bits = HUFF_LOOKUP_BITS - depth; //bits da janela que não pertencem ao código
+        uint32_t first = code << free_bits;
+        uint32_t count = 1u << free_bits;
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (is_leaf(node)) {
+                table->entries[first + i].symbol = node->character;
+                table->entries[first + i].length = (unsigned char)depth;
+            } else {
+                table->long_nodes[first + i] = node; //código longo: continua daqui
             }
+        }
+        return;
+    }
+
+    fill_decode_table(node->left, code << 1, depth + 1, table);
+    fill_decode_table(node->right, (code << 1) | 1, depth + 1, table);
+}
 
-            // Evita processar bits de "lixo" no último byte
-            // Para no ÚLTIMO byte (i == data_size - 1) 
-            // no ÚLTIMO bit válido (bit == trash_size - 1)
-            if (i == data_size - 1 && bit == trash_size - 1) { //os ultimos bits é o lixo e nao deve ser processado 
-                return;//A função termina assim que os bits válidos acabam, evitando decodificar lixo.
+// Monta a tabela a partir da árvore reconstruída por read_tree() (uma vez por arquivo)
+void build_decode_table(NODE* root, HuffDecodeTable* table) {
+    memset(table, 0, sizeof(*table));
+    table->single_symbol = is_leaf(root) ? root->character : -1;
+    if (!is_leaf(root)) fill_decode_table(root, 0, 0, table);
+}
+
+/*
+    CÓDIGOS CANÔNICOS
+
+    Para decodificar, não importa QUAL código cada byte recebe, só o
+    comprimento de cada um. Os códigos canônicos são distribuídos assim:
+    códigos mais curtos primeiro e, dentro do mesmo comprimento, em ordem
+    crescente de byte, cada um valendo o anterior + 1.
+
+    Exemplo: comprimentos A=1, B=2, R=2
+    A → 0
+    B → 10    (depois do último código de 1 bit: (0 + 1) << 1 = 10)
+    R → 11    (B + 1)
+
+    Então basta guardar os 256 comprimentos no cabeçalho (huff_canonical.h):
+    compactador e descompactador refazem os mesmos códigos, sem árvore.
+*/
+
+/*Preenche huff_table com os códigos canônicos para esses comprimentos.
+Retorna 0 se os comprimentos não formam um código de prefixo válido
+(comprimentos demais de um tamanho, ou algum maior que HUFF_MAX_CODE_BITS).*/
+int build_canonical_codes(const unsigned char lengths[256], HuffmanCode huff_table[256]) {
+    uint32_t count[HUFF_MAX_CODE_BITS + 1] = {0};
+    uint64_t next_code[HUFF_MAX_CODE_BITS + 2];
+    uint64_t used = 0; //quanto do espaço de códigos já foi ocupado, em unidades de 2^-32
+
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] > HUFF_MAX_CODE_BITS) return 0;
+        if (lengths[s] > 0) {
+            count[lengths[s]]++;
+            used += (uint64_t)1 << (HUFF_MAX_CODE_BITS - lengths[s]);
+        }
+    }
+    if (used > ((uint64_t)1 << HUFF_MAX_CODE_BITS)) return 0; //desigualdade de Kraft: não cabe
+
+    uint64_t code = 0;
+    next_code[1] = 0;
+    for (int len = 2; len <= HUFF_MAX_CODE_BITS; len++) {
+        code = (code + count[len - 1]) << 1; //primeiro código desse tamanho: depois do último do tamanho anterior
+        next_code[len] = code;
+    }
+
+    for (int s = 0; s < 256; s++) {
+        huff_table[s].length = lengths[s];
+        huff_table[s].code = lengths[s] ? (uint32_t)next_code[lengths[s]]++ : 0;
+    }
+    return 1;
+}
+
+/*
+    ÁRVORE COM PROFUNDIDADE LIMITADA (formato original)
+
+    O formato original guarda a árvore, não os comprimentos. Quando a árvore
+    de Huffman passa de max_bits níveis, refazemos só os nós internos: os
+    comprimentos vêm do package-merge (huff_length_limit.h), os códigos são
+    os canônicos e as folhas antigas são penduradas nos lugares novos.
+    As folhas continuam as mesmas (a segunda fila de create_huff_queue aponta
+    para elas) e os nós internos antigos são reaproveitados: uma árvore com n
+    folhas sempre tem n - 1 nós internos. Árvores que já cabem no limite não
+    mudam em nada.
+*/
+
+// Desmonta a árvore: folhas em leaves[byte], nós internos empilhados em spare
+void detach_leaves(NODE* node, NODE* leaves[256], NODE* spare[MAX_HEAP], int* spare_count) {
+    if (!node) return;
+    if (is_leaf(node)) {
+        leaves[node->character] = node;
+        return;
+    }
+    detach_leaves(node->left, leaves, spare, spare_count);
+    detach_leaves(node->right, leaves, spare, spare_count);
+    node->left = node->right = NULL;
+    spare[(*spare_count)++] = node;
+}
+
+/*Se algum código da tabela passa de max_bits, troca a árvore por uma equivalente com no
+máximo max_bits níveis e atualiza huff_table. Retorna a raiz (nova ou a mesma), ou NULL
+se não der para limitar (falta de memória no package-merge): nesse caso a árvore antiga
+já foi desmontada e huff_table não vale mais, quem chama precisa desistir.*/
+NODE* limit_huffman_tree(NODE* root, HuffmanCode huff_table[256], int max_bits) {
+    NODE* spare[MAX_HEAP];
+    int spare_count = 0;
+
+    int deepest = 0;
+    for (int s = 0; s < 256; s++) {
+        if (huff_table[s].length > deepest) deepest = huff_table[s].length;
+    }
+    if (!root || deepest <= max_bits) return root;
+
+    NODE* leaves[256] = {0};
+    uint64_t freq[256] = {0};
+    unsigned char lengths[256];
+    detach_leaves(root, leaves, spare, &spare_count);
+    for (int s = 0; s < 256; s++) {
+        if (leaves[s]) freq[s] = leaves[s]->frequency;
+    }
+
+    if (!huff_limited_code_lengths(freq, max_bits, lengths) || !build_canonical_codes(lengths, huff_table)) {
+        fprintf(stderr, "Erro: não foi possível limitar os códigos a %d bits\n", max_bits);
+        return NULL;
+    }
+
+    // Desce pelo código de cada byte pendurando os nós internos que faltam
+    root = spare[--spare_count];
+    for (int s = 0; s < 256; s++) {
+        if (!leaves[s]) continue;
+
+        NODE* node = root;
+        for (int bit = huff_table[s].length - 1; bit > 0; bit--) {
+            NODE** child = ((huff_table[s].code >> bit) & 1) ? &node->right : &node->left;
+            if (!*child) *child = spare[--spare_count];
+            node = *child;
+        }
+        if (huff_table[s].code & 1) node->right = leaves[s];
+        else node->left = leaves[s];
+    }
+    return root;
+}
+
+// Monta a tabela de decodificação direto dos comprimentos, sem árvore. Retorna 0 se os comprimentos forem inválidos
+int build_decode_table_from_lengths(const unsigned char lengths[256], HuffDecodeTable* table) {
+    HuffmanCode codes[256];
+    if (!build_canonical_codes(lengths, codes)) return 0;
+
+    memset(table, 0, sizeof(*table));
+    table->canonical = 1;
+    table->single_symbol = -1;
+
+    // 1. Códigos curtos: cada um ocupa 2^(janela - comprimento) entradas seguidas
+    for (int s = 0; s < 256; s++) {
+        int len = lengths[s];
+        if (len == 0 || len > HUFF_LOOKUP_BITS) continue;
+
+        uint32_t first = codes[s].code << (HUFF_LOOKUP_BITS - len);
+        uint32_t count = 1u << (HUFF_LOOKUP_BITS - len);
+        for (uint32_t i = 0; i < count; i++) {
+            table->entries[first + i].symbol = (unsigned char)s;
+            table->entries[first + i].length = (unsigned char)len;
+        }
+    }
+
+    // 2. Códigos longos: bytes ordenados por comprimento e o primeiro código de cada comprimento
+    uint32_t n = 0;
+    for (int len = 1; len <= HUFF_MAX_CODE_BITS; len++) {
+        table->first_index[len] = n;
+        for (int s = 0; s < 256; s++) {
+            if (lengths[s] != len) continue;
+            if (table->count[len] == 0) table->first_code[len] = codes[s].code; //códigos canônicos: o primeiro é o menor
+            table->symbols[n++] = (unsigned char)s;
+            table->count[len]++;
+            table->max_length = len;
+        }
+    }
+    return 1;
+}
+
+/*
+    DE ONDE VÊM OS COMPRIMENTOS
+
+    Os formatos com códigos canônicos só precisam dos comprimentos, e há duas
+    formas de obtê-los:
+    - HUFF_BUILD_HEAP: a árvore de sempre (fila de prioridade + malloc por nó);
+    - HUFF_BUILD_TWO_QUEUE: folhas ordenadas + duas filas, sem malloc (huff_two_queue.h).
+    As duas dão o mesmo tamanho de arquivo (empates podem trocar comprimentos
+    de lugar). Se o código mais longo passar de max_bits, os comprimentos são
+    refeitos com o package-merge (huff_length_limit.h).
+*/
+
+typedef enum {
+    HUFF_BUILD_HEAP,
+    HUFF_BUILD_TWO_QUEUE
+} HuffTreeBuilder;
+
+#ifndef HUFF_DEFAULT_BUILDER
+#define HUFF_DEFAULT_BUILDER HUFF_BUILD_TWO_QUEUE
+#endif
+
+// Comprimentos de no máximo max_bits bits para essas frequências. Retorna 0 se faltou memória
+int huff_code_lengths(const uint64_t freq[256], int max_bits, HuffTreeBuilder builder, unsigned char lengths[256]) {
+    HUFF_PROFILE_BEGIN(profile);
+    int deepest = 0;
+
+    if (builder == HUFF_BUILD_HEAP) {
+        NODE_POOL pool; //511 nós na pilha: nenhum malloc por árvore
+        reset_node_pool(&pool);
+        NODE* root = build_tree_from_frequencies(freq, &pool);
+        HuffmanCode huff_table[256] = {0};
+        create_huffman_table(root, 0, 0, huff_table);
+
+        for (int s = 0; s < 256; s++) {
+            lengths[s] = (unsigned char)huff_table[s].length;
+            if (freq[s] > 0 && lengths[s] == 0) lengths[s] = 1; //árvore de uma folha só
+            if (lengths[s] > deepest) deepest = lengths[s];
+        }
+    } else {
+        deepest = huff_two_queue_code_lengths(freq, lengths);
+    }
+
+    int ok = deepest <= max_bits || huff_limited_code_lengths(freq, max_bits, lengths);
+    HUFF_PROFILE_END(profile, HUFF_STAGE_CODE_LENGTHS, 0);
+    return ok;
+}
+
+// Quantos bits o bloco gasta com esses comprimentos (UINT64_MAX se algum byte presente não tem código)
+uint64_t huff_block_cost(const uint64_t freq[256], const unsigned char lengths[256]) {
+    uint64_t bits = 0;
+    for (int s = 0; s < 256; s++) {
+        if (freq[s] == 0) continue;
+        if (lengths[s] == 0) return UINT64_MAX;
+        bits += freq[s] * lengths[s];
+    }
+    return bits;
+}
+
+/*
+    CABEÇALHO COM OS COMPRIMENTOS
+
+    Em vez da árvore em pré-ordem (até 511 nós, com '\' de escape), guardamos
+    os 256 comprimentos de código, cada um com w bits, onde w é o menor
+    número de bits que cabe o maior comprimento (códigos de até 32 bits → w <= 6).
+
+    [1 byte]  bit 7 = formato esparso | bits 0-5 = w
+    denso:    256 comprimentos de w bits (byte 0, byte 1, ..., byte 255)
+    esparso:  32 bytes de mapa (bit s ligado = byte s aparece no arquivo)
+              + um comprimento de w bits para cada byte presente
+
+    Exemplo: texto só com "ABR" (comprimentos 1, 2, 2 → w = 2)
+    denso:   1 + 256*2/8 = 65 bytes
+    esparso: 1 + 32 + 1  = 34 bytes   ← escolhido
+
+    Um texto comum com 70 bytes diferentes e códigos de até 15 bits (w = 4):
+    árvore em pré-ordem: 70 folhas * 2 + 69 nós internos = 209 bytes
+    esparso:             1 + 32 + 70*4/8 = 68 bytes
+    O compactador escreve a versão menor.
+*/
+
+void write_code_lengths(HuffWriter* out, const unsigned char lengths[256]) {
+    int max_length = 0, present = 0;
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] > max_length) max_length = lengths[s];
+        if (lengths[s]) present++;
+    }
+
+    int width = 0;
+    while ((1 << width) <= max_length) width++;
+
+    int sparse = 32 * 8 + present * width < 256 * width; //em bits, sem contar o byte de formato
+    huff_write_byte(out, (unsigned char)((sparse ? 0x80 : 0) | width));
+
+    if (sparse) {
+        unsigned char map[32] = {0};
+        for (int s = 0; s < 256; s++) {
+            if (lengths[s]) map[s >> 3] |= (unsigned char)(0x80 >> (s & 7));
+        }
+        huff_write_bytes(out, map, sizeof(map));
+    }
+
+    BitWriter bits = {0, 0};
+    for (int s = 0; s < 256 && width > 0; s++) {
+        if (!sparse || lengths[s]) bit_writer_put(&bits, out, lengths[s], width);
+    }
+    bit_writer_finish(&bits, out);
+}
+
+// Quantos bytes write_code_lengths() escreveria para esses comprimentos
+size_t code_lengths_size(const unsigned char lengths[256]) {
+    int max_length = 0, present = 0;
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] > max_length) max_length = lengths[s];
+        if (lengths[s]) present++;
+    }
+
+    int width = 0;
+    while ((1 << width) <= max_length) width++;
+
+    int sparse = 32 * 8 + present * width < 256 * width;
+    size_t bits = (size_t)(sparse ? present : 256) * width;
+    return 1 + (sparse ? 32 : 0) + (bits + 7) / 8;
+}
+
+// Lê o que write_code_lengths() escreveu. Retorna 0 se o arquivo acabou antes
+int read_code_lengths(HuffReader* in, unsigned char lengths[256]) {
+    int format = huff_read_byte(in);
+    if (format == EOF) return 0;
+
+    int sparse = format & 0x80;
+    int width = format & 0x3F;
+    if (width > 6) return 0; //comprimentos maiores que 63 nunca são escritos
+
+    unsigned char map[32];
+    for (int i = 0; i < 32; i++) {
+        int byte = sparse ? huff_read_byte(in) : 0xFF; //denso = todos presentes
+        if (byte == EOF) return 0;
+        map[i] = (unsigned char)byte;
+    }
+
+    uint32_t acc = 0; //bits lidos e ainda não usados, alinhados à direita
+    int bit_count = 0;
+    for (int s = 0; s < 256; s++) {
+        lengths[s] = 0;
+        if (!(map[s >> 3] & (0x80 >> (s & 7))) || width == 0) continue;
+
+        while (bit_count < width) {
+            int byte = huff_read_byte(in);
+            if (byte == EOF) return 0;
+            acc = (acc << 8) | (unsigned)byte;
+            bit_count += 8;
+        }
+        bit_count -= width;
+        lengths[s] = (unsigned char)((acc >> bit_count) & ((1u << width) - 1));
+    }
+    return 1;
+}
+
+/*Caminho lento: o código não cabe na janela. acc tem os próximos bits alinhados à esquerda.
+Retorna o byte e coloca em *length quantos bits ele usa (0 = bits inválidos).*/
+int decode_long_code(const HuffDecodeTable* table, uint64_t acc, int* length) {
+    if (!table->canonical) {
+        NODE* node = table->long_nodes[acc >> (64 - HUFF_LOOKUP_BITS)];
+        int used = HUFF_LOOKUP_BITS;
+
+        while (node && !is_leaf(node) && used < 64) {
+            node = ((acc << used) >> 63) ? node->right : node->left;
+            used++;
+        }
+        if (!node || !is_leaf(node)) {
+            *length = 0;
+            return 0;
+        }
+        *length = used;
+        return node->character;
+    }
+
+    for (int len = HUFF_LOOKUP_BITS + 1; len <= table->max_length; len++) {
+        uint32_t code = (uint32_t)(acc >> (64 - len));
+        uint32_t offset = code - table->first_code[len]; //se code < first_code, dá a volta e fica enorme
+
+        if (offset < table->count[len]) {
+            *length = len;
+            return table->symbols[table->first_index[len] + offset];
+        }
+    }
+    *length = 0;
+    return 0;
+}
+
+/*Núcleo do descompactador: lê bits de "in", escreve bytes em "out".
+Para quando acabarem os bits válidos (bits_left) OU quando já tiver escrito
+max_symbols bytes, o que vier primeiro. Retorna quantos bytes escreveu.
+
+Formato original (.huff de um bloco só): bits_left = bits do corpo menos o lixo
+Formatos novos: max_symbols = tamanho original (huff_chunked.h, huff_canonical.h)*/
+uint64_t huff_decode_stream(HuffReader* in, HuffWriter* out, const HuffDecodeTable* table,
+                            int64_t bits_left, uint64_t max_symbols) {
+    HUFF_PROFILE_BEGIN(profile);
+    uint64_t written = 0;
+
+    //Árvore de uma folha só gera códigos de 0 bits: o byte simplesmente se repete
+    if (table->single_symbol >= 0) {
+        while (written < max_symbols && bits_left > 0) {
+            huff_write_byte(out, (unsigned char)table->single_symbol);
+            written++;
+        }
+        HUFF_PROFILE_END(profile, HUFF_STAGE_DECODE, written);
+        return written;
+    }
+
+    /*Acumulador de bits: os próximos bits do arquivo ficam alinhados à esquerda
+    (bit 63 = próximo bit a ser lido). bit_count diz quantos deles são válidos.
+
+    Ler um byte novo:  acc |= byte << (56 - bit_count)
+    Espiar a janela:   acc >> (64 - HUFF_LOOKUP_BITS)
+    Consumir n bits:   acc <<= n*/
+    uint64_t acc = 0;
+    int bit_count = 0;
+
+    /*Os bytes entram e saem por ponteiros locais, não por in->pos / out->pos: cada
+    escrita num unsigned char* pode, para o compilador, ter mudado pos, e ele teria
+    de ler e gravar pos na memória a cada byte. Os campos só são atualizados na
+    troca de bloco e no fim. Com a saída mapeada (huff_writer_open_sized), dst
+    aponta direto para o arquivo.*/
+    const unsigned char* src = in->data + in->pos;
+    const unsigned char* src_end = in->data + in->len;
+    unsigned char* dst = out->data + out->pos;
+    unsigned char* dst_end = out->data + out->capacity;
+
+    while (bits_left > 0 && written < max_symbols) {
+        // 1. Completa o acumulador (até 7 bytes novos por vez)
+        while (bit_count <= 56) {
+            if (src == src_end) {
+                in->pos = in->len;
+                huff_reader_refill(in);
+                src = in->data + in->pos;
+                src_end = in->data + in->len;
+                if (src == src_end) break; //fim do arquivo: o resto da janela fica com zeros
             }
+            acc |= (uint64_t)*src++ << (56 - bit_count);
+            bit_count += 8;
         }
+
+        // 2. Uma consulta resolve o código inteiro (caso comum)
+        HuffLookupEntry entry = table->entries[acc >> (64 - HUFF_LOOKUP_BITS)];
+        int symbol = entry.symbol;
+        int length = entry.length;
+
+        // 3. Código maior que a janela: caminho lento
+        if (length == 0) symbol = decode_long_code(table, acc, &length);
+
+        if (length == 0 || length > bit_count || length > bits_left) break; //corpo truncado/corrompido
+
+        acc <<= length;
+        bit_count -= length;
+        bits_left -= length;
+
+        if (dst == dst_end) { //bloco de escrita cheio
+            out->pos = out->capacity;
+            huff_writer_flush(out);
+            dst = out->data + out->pos;
+            dst_end = out->data + out->capacity;
+        }
+        *dst++ = (unsigned char)symbol;
+        written++;
+    }
+    in->pos = (size_t)(src - in->data);
+    out->pos = (size_t)(dst - out->data);
+
+    HUFF_PROFILE_END(profile, HUFF_STAGE_DECODE, written);
+    return written;
+}
+
+/*Percorre os bits do corpo compactado e escreve os caracteres no arquivo de saída.
+Retorna 1 se deu certo.*/
+int decompress(FILE *input, FILE *output, NODE* root, uint64_t header_bytes, uint64_t original_size, int trash_size) {
+    // input: arquivo compactado (.huff) para ler
+    // output: arquivo descompactado para escrever
+    // root: raiz da árvore de Huffman reconstruída
+    // header_bytes: quantos bytes pular (cabeçalho + árvore)
+    // original_size: quantos bytes escrever (HUFF_SIZE_UNKNOWN no .huff antigo)
+    // trash_size: só no .huff antigo, quantos bits ignorar no último byte (0-7)
+
+    int64_t bits_left = INT64_MAX; //com o tamanho original, quem para o laço é max_symbols
+    if (original_size == HUFF_SIZE_UNKNOWN) {
+        //.huff antigo: o fim dos dados vem do tamanho do arquivo menos o lixo
+        uint64_t file_size;
+        if (!huff_file_size(input, &file_size) || file_size < header_bytes) return 0;
+        bits_left = (int64_t)((file_size - header_bytes) * 8) - trash_size;
+
+        //Árvore de uma folha só gera códigos de 0 bits: no formato antigo o corpo fica vazio
+        if (!root) return 0;
+        if (bits_left <= 0) return 1;
+    } else if (original_size == 0) {
+        return 1; //arquivo vazio: não há árvore nem corpo
+    } else if (!root) {
+        return 0;
+    }
+
+    int checked = original_size != HUFF_SIZE_UNKNOWN && !is_leaf(root); //tamanho que dá para conferir e reservar
+    uint64_t file_size;
+    if (checked && (!huff_file_size(input, &file_size) || file_size < header_bytes ||
+                    original_size > (file_size - header_bytes) * 8)) {
+        return 0;
+    }
+
+    if (!huff_seek(input, header_bytes)) return 0; // Vai para o INÍCIO dos dados
+
+    HuffDecodeTable* table = malloc(sizeof(HuffDecodeTable));
+    if (!table) {
+        perror("Erro ao alocar tabela de decodificação");
+        return 0;
+    }
+    build_decode_table(root, table);
+
+    HuffReader reader; //lemos e escrevemos em blocos, nunca byte a byte (ver huff_io.h)
+    HuffWriter writer;
+    if (!huff_reader_open_mapped(&reader, input)) { //o mapeamento começa depois do cabeçalho (posição atual)
+        free(table);
+        return 0;
     }
+    /*Com o tamanho original, a saída é reservada e mapeada: os bytes vão direto para o arquivo (ver huff_io.h).
+    Só reservamos um tamanho que os bits conseguem gerar (cada byte gasta pelo menos um bit, mais
+    que isso é cabeçalho corrompido). Árvore de uma folha só gasta 0 bits por byte, então não dá
+    para conferir: a saída cresce conforme é escrita, sem reserva.*/
+    int opened = checked ? huff_writer_open_sized(&writer, output, original_size) : huff_writer_open(&writer, output, 0);
+    if (!opened) {
+        huff_reader_close(&reader);
+        free(table);
+        return 0;
+    }
+
+    HUFF_PROFILE_BEGIN(profile);
+    uint64_t written = huff_decode_stream(&reader, &writer, table, bits_left, original_size);
+    HUFF_PROFILE_END(profile, HUFF_STAGE_DECOMPRESS, written);
+
+    int ok = original_size == HUFF_SIZE_UNKNOWN || written == original_size; //faltou byte: corpo truncado
+    if (!huff_writer_close(&writer)) {
+        perror("Erro ao escrever o arquivo descompactado");
+        ok = 0;
+    }
+    huff_reader_close(&reader);
+    free(table);
+    return ok;
+}
+
+/*
+    FORMATOS DE ARQUIVO
+
+    O formato original nunca começa com 'H' (0x48): isso daria uma árvore com
+    mais de 2048 nós no campo de 13 bits, e a árvore tem no máximo 511.
+    Os formatos novos começam com 4 letras ("número mágico") e decompact()
+    escolhe o descompactador certo olhando só o começo do arquivo.
+*/
+
+#define HUFF_CHUNKED_MAGIC "HUFC"   //pedaços em paralelo (huff_chunked.h)
+#define HUFF_CANONICAL_MAGIC "HUFK" //códigos canônicos, cabeçalho só com comprimentos (huff_canonical.h)
+#define HUFF_STREAM_MAGIC "HUFS"    //blocos em fluxo, stdin → stdout (huff_stream.h)
+#define HUFF_ADAPTIVE_MAGIC "HUFA"  //Huffman adaptativo, uma passada só (huff_adaptive.h)
+#define HUFF_ORDER1_MAGIC "HUFO"    //uma tabela por byte anterior (huff_order1.h)
+#define HUFF_LZ_MAGIC "HUFL"        //LZ77 + tabelas separadas para literais, comprimentos e distâncias (huff_lz.h)
+#define HUFF_DICTIONARY_MAGIC "HUFD" //tabela pré-treinada, só o ID do dicionário no cabeçalho (huff_dictionary.h)
+#define HUFF_STORED_MAGIC "HUFR"    //guardado sem compactar, quando o Huffman aumentaria o arquivo (huff_stored.h)
+//"HUFT" (HUFF_TREE_MAGIC) é o próprio formato original com o tamanho em 64 bits, definido junto de write_header()
+
+typedef enum {
+    HUFF_FORMAT_ORIGINAL,
+    HUFF_FORMAT_CHUNKED,
+    HUFF_FORMAT_CANONICAL,
+    HUFF_FORMAT_STREAM,
+    HUFF_FORMAT_ADAPTIVE,
+    HUFF_FORMAT_ORDER1,
+    HUFF_FORMAT_LZ,
+    HUFF_FORMAT_DICTIONARY,
+    HUFF_FORMAT_STORED,
+    HUFF_FORMAT_TREE      //original com cabeçalho "HUFT"
+} HuffFormat;
+
+// Olha os 4 primeiros bytes e volta para o início do arquivo
+HuffFormat detect_format(FILE* file) {
+    unsigned char magic[4];
+    size_t got = fread(magic, 1, 4, file);
+    rewind(file);
+
+    if (got == 4 && memcmp(magic, HUFF_CHUNKED_MAGIC, 4) == 0) return HUFF_FORMAT_CHUNKED;
+    if (got == 4 && memcmp(magic, HUFF_CANONICAL_MAGIC, 4) == 0) return HUFF_FORMAT_CANONICAL;
+    if (got == 4 && memcmp(magic, HUFF_STREAM_MAGIC, 4) == 0) return HUFF_FORMAT_STREAM;
+    if (got == 4 && memcmp(magic, HUFF_ADAPTIVE_MAGIC, 4) == 0) return HUFF_FORMAT_ADAPTIVE;
+    if (got == 4 && memcmp(magic, HUFF_ORDER1_MAGIC, 4) == 0) return HUFF_FORMAT_ORDER1;
+    if (got == 4 && memcmp(magic, HUFF_LZ_MAGIC, 4) == 0) return HUFF_FORMAT_LZ;
+    if (got == 4 && memcmp(magic, HUFF_DICTIONARY_MAGIC, 4) == 0) return HUFF_FORMAT_DICTIONARY;
+    if (got == 4 && memcmp(magic, HUFF_STORED_MAGIC, 4) == 0) return HUFF_FORMAT_STORED;
+    if (got == 4 && memcmp(magic, HUFF_TREE_MAGIC, 4) == 0) return HUFF_FORMAT_TREE;
+    return HUFF_FORMAT_ORIGINAL;
+}
+
+// Implementados em huff_chunked.h, huff_canonical.h, huff_stream.h, huff_adaptive.h, huff_order1.h, huff_lz.h e huff_stored.h (declaração antecipada: "confia em mim, essa função existe mais adiante")
+int decompress_chunked(FILE* input, FILE* output);
+int decompress_canonical(FILE* input, FILE* output);
+int decompress_stream(FILE* input, FILE* output);
+int decompress_adaptive(FILE* input, FILE* output);
+int decompress_order1(FILE* input, FILE* output);
+int decompress_lz(FILE* input, FILE* output);
+int decompress_stored(FILE* input, FILE* output);
+
+/*Descompacta input em output, seja qual for o formato (detect_format).
+Não abre nem fecha arquivos: decompact() e o modo em lote (huff_ctx.h) chamam
+esta função com os arquivos já abertos. Retorna 1 se deu certo.*/
+int decompress_file(FILE* input, FILE* output) {
+    HuffFormat format = detect_format(input);
+    switch (format) {
+        case HUFF_FORMAT_CHUNKED:   return decompress_chunked(input, output);
+        case HUFF_FORMAT_CANONICAL: return decompress_canonical(input, output);
+        case HUFF_FORMAT_STREAM:    return decompress_stream(input, output);
+        case HUFF_FORMAT_ADAPTIVE:  return decompress_adaptive(input, output);
+        case HUFF_FORMAT_ORDER1:    return decompress_order1(input, output);
+        case HUFF_FORMAT_LZ:        return decompress_lz(input, output);
+        case HUFF_FORMAT_STORED:    return decompress_stored(input, output);
+        case HUFF_FORMAT_DICTIONARY: //a tabela não está no arquivo: só com o dicionário (decompress_dictionary)
+            fprintf(stderr, "Erro: arquivo compactado com dicionário; use -D dicionario -d\n");
+            return 0;
+        default: break;
+    }
+
+    int trash_size = 0, tree_size = 0, bytes_read = 0;
+    //tam lixo , tam arvore , byte lido :conta quantos bytes da árvore foram lidos (para saber onde começa o corpo compactado)
+    uint64_t original_size = HUFF_SIZE_UNKNOWN;
+    uint64_t header_bytes = 2;
+    HUFF_PROFILE_BEGIN(header_profile);
+    if (format == HUFF_FORMAT_TREE) {
+        if (!read_header_64(input, &original_size)) return 0; //Lê o tamanho original
+        header_bytes = HUFF_TREE_HEADER_SIZE;
+    } else {
+        read_header(input, &trash_size, &tree_size); //.huff antigo: lê o lixo e o tamanho da árvore
+    }
+    HUFF_PROFILE_END(header_profile, HUFF_STAGE_READ_HEADER, header_bytes);
+
+    HuffReader tree_reader; //a árvore é lida pelo bloco de leitura; decompress() reposiciona o arquivo depois
+    NODE_POOL* pool = create_node_pool(); //todos os nós da árvore num bloco só (ver pqueue_heap.h)
+    if (!pool || !huff_reader_open(&tree_reader, input, 0)) {
+        free_node_pool(pool);
+        return 0;
+    }
+    NODE* root = NULL;
+    HUFF_PROFILE_BEGIN(tree_profile);
+    if (original_size != 0) root = read_tree(&tree_reader, &bytes_read, pool); //Reconstrói a árvore de Huffman a partir dos bytes seguintes
+    HUFF_PROFILE_END(tree_profile, HUFF_STAGE_READ_TREE, bytes_read);
+    huff_reader_close(&tree_reader);
+
+
+    int ok = decompress(input, output, root, header_bytes + bytes_read, original_size, trash_size); //Descompacta o corpo usando a árvore
+    /*
+    O que header_bytes + bytes_read realmente significa:
+
+    header_bytes = bytes do CABEÇALHO
+    13 no "HUFT" (magic, versão, tamanho original); 2 no antigo (lixo e tamanho da árvore)
+    
+    bytes_read = bytes da ÁRVORE
+    Quantos bytes foram lidos para reconstruir a árvore
+    
+    header_bytes + bytes_read = TOTAL de bytes para PULAR
+
+    [13 bytes: cabeçalho][X bytes: árvore][dados...]
+     ↑                   ↑                ↑
+    cabeçalho          árvore           dados começam AQUI
+
+    = posição onde os dados compactados começam
+    */
+
+    free_node_pool(pool); //libera a árvore inteira de uma vez
+    return ok;
 }
 
 // Função principal chamada na main
@@ -629,46 +1319,37 @@ void decompact(const char* compressed_filename, char final_format[]) {
    - 1 ('\0')
    = 237 caracteres máximos para o nome base*/
 
-    FILE *output_file = fopen(output_filename, "wb"); //abre arquivo em modo de escrita em binario"wb"
+    FILE *output_file = fopen(output_filename, "w+b"); //abre arquivo novo em binario para escrita e leitura "w+b"
+    //o "+" (leitura) é o que permite mapear a saída e decodificar direto nela (huff_writer_open_sized)
     if (!output_file) {
         perror("Erro ao criar arquivo de saída");
         fclose(input_file);
         return;
     }
     
-    //Lê o cabeçalho     
-    int trash_size = 0, tree_size = 0, bytes_read = 0;
-    //tam lixo , tam arvore , byte lido :conta quantos bytes da árvore foram lidos (para saber onde começa o corpo compactado)
-    read_header(input_file, &trash_size, &tree_size); //Lê o lixo e o tamanho da árvore
-    NODE* root = read_tree(input_file, &bytes_read); //Reconstrói a árvore de Huffman a partir dos próximos tree_size bytes
-
-
-    decompress(input_file, output_file, root, trash_size, 2 + bytes_read); //Descompacta o corpo usando a árvore
-    /*
-    O que 2 + bytes_read realmente significa:
-
-    2 = bytes do CABEÇALHO
-    Byte 1 + Byte 2 = 2 bytes com informações do lixo e tamanho da árvore
-    
-    bytes_read = bytes da ÁRVORE
-    Quantos bytes foram lidos para reconstruir a árvore
-    
-    2 + bytes_read = TOTAL de bytes para PULAR
-
-    [2 bytes: cabeçalho][X bytes: árvore][dados...]
-     ↑                   ↑                ↑
-    cabeçalho          árvore           dados começam AQUI
-
-    = posição onde os dados compactados começam
-    */
-
-    printf("Arquivo descompactado com sucesso: %s\n", output_filename);
+    //Formatos novos têm o próprio descompactador
+    if (decompress_file(input_file, output_file)) {
+        printf("Arquivo descompactado com sucesso: %s\n", output_filename);
+    } else {
+        fprintf(stderr, "Erro: arquivo compactado corrompido\n");
+    }
 
-    free_huffman_tree(root);
     fclose(input_file);
     fclose(output_file);
 }
 
 
 
+#include "huff_stored.h"    //guardado sem compactar (dados que não encolhem)
+#include "huff_chunked.h"   //formato em pedaços (precisa de tudo que foi definido acima)
+#include "huff_canonical.h" //formato canônico
+#include "huff_stream.h"    //formato em fluxo (stdin → stdout)
+#include "huff_adaptive.h"  //Huffman adaptativo (uma passada)
+#include "huff_order1.h"    //uma tabela por byte anterior (ordem 1)
+#include "huff_lz.h"        //LZ77 antes do Huffman (repetições longas)
+#include "huff_ctx.h"       //contexto reaproveitável (muitos arquivos no mesmo processo)
+#include "huff_buffer.h"    //memória → memória, no buffer de quem chama
+#include "huff_batch.h"     //lote em paralelo (diretórios inteiros)
+#include "huff_dictionary.h" //dicionário pré-treinado (mensagens pequenas)
+
 #endif // HUFFMAN_H
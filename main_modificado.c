@@ -8,18 +8,148 @@
 
 #define BUFFER_SIZE 1024
 
-int main() {
+// Nome da saída nos modos sem menu: a.txt → a.txt.huff → a.txt (sem .huff no fim: a.txt.out)
+void batch_output_name(int compress, const char* input_name, char* output_name, size_t size) {
+    size_t length = strlen(input_name);
+
+    if (compress) {
+        snprintf(output_name, size, "%s.huff", input_name);
+    } else if (length > 5 && strcmp(input_name + length - 5, ".huff") == 0) {
+        snprintf(output_name, size, "%.*s", (int)(length - 5), input_name); //tira o .huff
+    } else {
+        snprintf(output_name, size, "%s.out", input_name);
+    }
+}
+
+/*Modo em lote, sem menu: um processo e um huff_ctx para todos os arquivos (ver huff_ctx.h)
+./programa -c a.txt b.txt ...      → a.txt.huff b.txt.huff ...
+./programa -d a.txt.huff ...       → a.txt ...
+Retorna quantos arquivos falharam.*/
+int batch_mode(int compress, int count, char* files[]) {
+    huff_ctx* ctx = huff_ctx_create();
+    if (ctx == NULL) {
+        perror("Erro ao criar o contexto");
+        return count;
+    }
+
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        char output_name[BUFFER_SIZE];
+        batch_output_name(compress, files[i], output_name, sizeof(output_name));
+
+        int ok = compress ? huff_ctx_compress_file(ctx, files[i], output_name)
+                          : huff_ctx_decompress_file(ctx, files[i], output_name);
+        if (ok) {
+            printf("%s → %s\n", files[i], output_name);
+        } else {
+            fprintf(stderr, "Erro ao processar %s\n", files[i]);
+            failures++;
+        }
+    }
+
+    huff_ctx_free(ctx);
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
     int option;
+
+    /*Dicionário pré-treinado (ver huff_dictionary.h)
+    ./programa -T msgs.hdic exemplo1 exemplo2 ...    treina com os exemplos e salva o dicionário
+    ./programa -D msgs.hdic -c msg1 msg2 ...         → msg1.huff ... (cabeçalho com o ID do dicionário)
+    ./programa -D msgs.hdic -d msg1.huff ...         → msg1 ...*/
+    if (argc > 3 && strcmp(argv[1], "-T") == 0) {
+        HuffDictionary* dict = malloc(sizeof(HuffDictionary));
+        int ok = dict && huff_dict_train_files(argv + 3, (size_t)(argc - 3), dict) && huff_dict_save(dict, argv[2]);
+        if (ok) printf("Dicionário %08x salvo em %s\n", dict->id, argv[2]);
+        free(dict);
+        return ok ? 0 : 1;
+    }
+    if (argc > 4 && strcmp(argv[1], "-D") == 0 && (strcmp(argv[3], "-c") == 0 || strcmp(argv[3], "-d") == 0)) {
+        HuffDictionary* dict = malloc(sizeof(HuffDictionary)); //a tabela de decodificação é grande para a pilha
+        if (!dict || !huff_dict_load(dict, argv[2])) {
+            free(dict);
+            return 1;
+        }
+        int compress = argv[3][1] == 'c', failures = 0;
+
+        for (int i = 4; i < argc; i++) {
+            char output_name[BUFFER_SIZE];
+            batch_output_name(compress, argv[i], output_name, sizeof(output_name));
+
+            FILE* input = fopen(argv[i], "rb");
+            FILE* output = input ? fopen(output_name, "wb") : NULL;
+            int ok = input && output && (compress ? compress_dictionary(input, output, dict) : decompress_dictionary(input, output, dict));
+            if (output && fclose(output) != 0) ok = 0;
+            if (input) fclose(input);
+
+            if (ok) printf("%s → %s\n", argv[i], output_name);
+            else {
+                fprintf(stderr, "Erro ao processar %s\n", argv[i]);
+                if (output) remove(output_name); //não deixa um arquivo pela metade
+                failures++;
+            }
+        }
+        free(dict);
+        return failures == 0 ? 0 : 1;
+    }
+
+    /*Lote em paralelo: arquivos e diretórios, todos os núcleos (ver huff_batch.h)
+    ./programa -p [-t threads] pasta arquivo ...*/
+    if (argc > 2 && strcmp(argv[1], "-p") == 0) {
+        int threads = 0, first = 2;
+        if (argc > 4 && strcmp(argv[2], "-t") == 0) {
+            threads = atoi(argv[3]);
+            first = 4;
+        }
+
+        HuffBatchStats stats;
+        int ok = compress_batch(argv + first, (size_t)(argc - first), HUFF_CHUNK_SIZE, threads, &stats);
+        double mb = stats.input_bytes / (1024.0 * 1024.0);
+        printf("%zu arquivos (%zu com erro), %d threads: %.1f MB → %.1f MB (%.1f%%) em %.2f s = %.1f MB/s\n",
+               stats.files, stats.failures, stats.threads, mb, stats.output_bytes / (1024.0 * 1024.0),
+               stats.input_bytes ? 100.0 * stats.output_bytes / stats.input_bytes : 0.0,
+               stats.seconds, stats.seconds > 0 ? mb / stats.seconds : 0.0);
+        return ok ? 0 : 1;
+    }
+
+    if (argc > 2 && (strcmp(argv[1], "-c") == 0 || strcmp(argv[1], "-d") == 0)) {
+        return batch_mode(argv[1][1] == 'c', argc - 2, argv + 2) == 0 ? 0 : 1;
+    }
+
+    /*Modo pipe, sem menu: lê stdin e escreve stdout em blocos (ver huff_stream.h)
+    produtor_de_logs | ./programa -c > logs.huff
+    ./programa -d < logs.huff > logs.txt*/
+    if (argc == 2 && strcmp(argv[1], "-c") == 0) {
+        if (!compress_stream(stdin, stdout, HUFF_STREAM_BLOCK_SIZE)) {
+            fprintf(stderr, "Erro ao compactar a entrada padrão\n");
+            return 1;
+        }
+        return 0;
+    }
+    if (argc == 2 && strcmp(argv[1], "-d") == 0) {
+        if (!decompress_stream(stdin, stdout)) {
+            fprintf(stderr, "Erro: fluxo compactado corrompido\n");
+            return 1;
+        }
+        return 0;
+    }
     
     printf("====== Compactador Huffman ======\n");
     printf("Escolha uma opção:\n");
     printf("1 - Compactar arquivo\n");
     printf("2 - Descompactar arquivo\n");
+    printf("3 - Compactar arquivo em pedaços (usa todos os núcleos)\n");
+    printf("4 - Compactar arquivo com códigos canônicos (cabeçalho menor)\n");
+    printf("5 - Compactar arquivo com Huffman adaptativo (lê o arquivo uma vez só)\n");
+    printf("6 - Compactar arquivo com contexto de ordem 1 (melhor para texto e logs)\n");
+    printf("7 - Compactar arquivo com LZ77 + Huffman (trechos repetidos: logs, CSV, zeros)\n");
+    printf("8 - Compactar arquivo em pedaços com 4 fluxos intercalados (descompactação mais rápida)\n");
     printf("Opção: ");
     scanf("%d", &option);
     getchar(); // Limpa o buffer do ENTER
 
-    if (option == 1) {
+    if (option == 1 || (option >= 3 && option <= 8)) {
         printf("\nInsira o nome do arquivo a ser compactado, com a extensao:\n");
 
         char filename[BUFFER_SIZE];
@@ -61,26 +191,93 @@ int main() {
             return 1;
         }
 
+        if (option != 1) {
+            // 3: cada pedaço de 1 MiB ganha os próprios códigos e é compactado em paralelo (ver huff_chunked.h)
+            // 4: um fluxo só, com os comprimentos no cabeçalho no lugar da árvore (ver huff_canonical.h)
+            // 5: a árvore muda a cada byte, nada de cabeçalho nem segunda leitura (ver huff_adaptive.h)
+            // 6: uma tabela para cada byte anterior, quando compensa (ver huff_order1.h)
+            // 7: trechos repetidos viram cópias (comprimento, distância) antes do Huffman (ver huff_lz.h)
+            // 8: como o 3, mas cada pedaço vira 4 fluxos decodificados juntos (ver huff_chunked.h)
+            int ok = 0;
+            if (option == 3) ok = compress_chunked(original_file, new_file, HUFF_CHUNK_SIZE, 0, HUFF_CHUNK_CANONICAL);
+            if (option == 8) ok = compress_chunked(original_file, new_file, HUFF_CHUNK_SIZE, 0, HUFF_CHUNK_INTERLEAVED);
+            if (option == 4) ok = compress_canonical(original_file, new_file);
+            if (option == 5) ok = compress_adaptive(original_file, new_file);
+            if (option == 6) ok = compress_order1(original_file, new_file);
+            if (option == 7) {
+                int level = HUFF_LZ_DEFAULT_LEVEL;
+                printf("Nível (0 = só RLE, rápido ... 9 = melhor taxa) [%d]: ", level);
+                if (scanf("%d", &level) != 1) level = HUFF_LZ_DEFAULT_LEVEL;
+                ok = compress_lz(original_file, new_file, level);
+            }
+
+            fclose(original_file);
+            fclose(new_file);
+
+            if (!ok) {
+                fprintf(stderr, "Erro ao compactar o arquivo\n");
+                return 1;
+            }
+            printf("Arquivo compactado com sucesso: %s\n", new_file_name);
+            return 0;
+        }
+
         // Cria as duas filas de prioridade
         PRIORITY_QUEUE* huff_queue1 = create_queue();
         PRIORITY_QUEUE* huff_queue2 = create_queue();
+        NODE_POOL* pool = create_node_pool(); // Todos os nós da árvore saem daqui (um malloc só)
+        if (pool == NULL) {
+            perror("Erro ao alocar os nós da árvore");
+            return 1;
+        }
 
         // Preenche as filas com as frequências dos caracteres do arquivo
-        create_huff_queue(original_file, &huff_queue1, &huff_queue2);
+        create_huff_queue(original_file, &huff_queue1, &huff_queue2, pool);
 
         // Constrói a árvore de Huffman
-        NODE* root = build_huffman_tree(huff_queue1);
+        NODE* root = build_huffman_tree(huff_queue1, pool);
 
         // Cria a tabela de códigos de Huffman
         HuffmanCode huff_table[256] = {0}; // Inicializa a tabela de Huffman
         uint32_t code = 0; // Inicializa o código como um inteiro
         create_huffman_table(root, code, 0, huff_table); // Passa o código como ponteiro
 
+        // Árvores muito fundas (frequências tipo Fibonacci) são refeitas com no máximo HUFF_MAX_CODE_LENGTH níveis
+        NODE* limited = limit_huffman_tree(root, huff_table, HUFF_MAX_CODE_LENGTH);
+        if (root && !limited) { //o erro já foi mostrado
+            free_node_pool(pool);
+            free_priority_queue(huff_queue1);
+            free_priority_queue(huff_queue2);
+            fclose(original_file);
+            fclose(new_file);
+            return 1;
+        }
+        root = limited;
+
+        // Dados que não encolhem (JPEG, zip...): o arquivo é guardado como está (ver huff_stored.h)
+        uint64_t original_size = root ? root->frequency : 0;
+        uint64_t header_bytes = HUFF_TREE_HEADER_SIZE + tree_serialized_size(root);
+        if (root && huff_store_is_smaller(tree_coded_bits(root, huff_table), header_bytes, original_size + HUFF_STORED_HEADER_SIZE)) {
+            free_node_pool(pool);
+            free_priority_queue(huff_queue1);
+            free_priority_queue(huff_queue2);
+
+            int ok = compress_stored(original_file, new_file, original_size);
+            fclose(original_file);
+            if (fclose(new_file) != 0) ok = 0;
+            if (!ok) {
+                fprintf(stderr, "Erro ao compactar o arquivo\n");
+                return 1;
+            }
+            printf("Arquivo guardado sem compactar (não encolheria): %s\n", new_file_name);
+            return 0;
+        }
+
         // Escreve o cabeçalho e a árvore no novo arquivo
         write_header(huff_queue2, huff_table, new_file, root);
 
         // Libera memória usada
-        free_huffman_tree(root);
+        free_node_pool(pool); // A árvore inteira de uma vez
         free_priority_queue(huff_queue1);
         free_priority_queue(huff_queue2);
 
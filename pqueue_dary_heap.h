@@ -0,0 +1,246 @@
+/*OBJETIVO PRINCIPAL:
+Uma fila de prioridade genérica (não só para NODE*), sem limite de 256 elementos,
+que permite mudar a prioridade de quem já está na fila. Serve para a ordem das
+variáveis de um resolvedor SAT (estilo VSIDS), para escalonar tarefas etc.
+
+Diferenças para o PRIORITY_QUEUE de pqueue_heap.h:
+
+1. d-ária: cada nó tem d filhos (4 por padrão) em vez de 2.
+   A árvore fica com metade da altura, e os 4 filhos estão lado a lado no
+   vetor (mesma linha de cache). Subir fica mais barato; descer compara 4 filhos
+   por nível, mas com metade dos níveis.
+
+   Pai de i: (i - 1) / d        Filhos de i: d*i + 1 ... d*i + d
+
+2. Indexada: a fila guarda números (ids 0 .. capacity-1) e a prioridade de
+   cada id fica em key[id]. position[id] diz onde o id está no heap, então
+   dá para achar qualquer elemento em O(1) e mudar sua prioridade
+   (dheap_decrease_key / dheap_increase_key) sem procurar no vetor.
+
+3. "Buraco" em vez de swap(): para subir um elemento, guardamos ele de lado e
+   vamos descendo os pais para o buraco. Ele só é escrito uma vez, na posição
+   final. O swap() escreve os dois lados a cada nível.
+
+   swap:    [5]←→[3], [3]←→[1] ...   (2 escritas por nível)
+   buraco:  guarda 1, [pai] desce, [avô] desce, escreve 1   (1 escrita por nível)
+
+4. Iterativa (laço), não recursiva.
+
+5. dheap_build(): monta o heap de n elementos de uma vez em O(n), descendo
+   os nós internos do último para o primeiro (em vez de n inserções, O(n log n)).
+
+Tipo da prioridade: uint64_t por padrão. Para outro tipo, definir antes do include:
+#define DHEAP_KEY double
+#include "pqueue_dary_heap.h"
+
+Menor prioridade sai primeiro. Para "maior primeiro" (ex.: atividade no VSIDS),
+guarde a prioridade com o sinal trocado.
+*/
+
+#ifndef PQUEUE_DARY_HEAP_H
+#define PQUEUE_DARY_HEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifndef DHEAP_KEY
+#define DHEAP_KEY uint64_t
+#endif
+
+#ifndef DHEAP_DEFAULT_ARITY
+#define DHEAP_DEFAULT_ARITY 4
+#endif
+
+typedef struct {
+    int* heap;        // ids em ordem de heap (heap[0] = menor prioridade)
+    int* position;    // position[id] = índice em heap, -1 = fora da fila
+    DHEAP_KEY* key;   // key[id] = prioridade do id
+    int size;
+    int capacity;     // ids válidos: 0 .. capacity-1
+    int arity;        // filhos por nó
+} DHEAP;
+
+// arity <= 1 usa DHEAP_DEFAULT_ARITY. Retorna NULL se faltar memória
+DHEAP* dheap_create(int capacity, int arity) {
+    DHEAP* h = malloc(sizeof(DHEAP));
+    if (!h) return NULL;
+
+    h->heap = malloc(sizeof(int) * (size_t)capacity);
+    h->position = malloc(sizeof(int) * (size_t)capacity);
+    h->key = malloc(sizeof(DHEAP_KEY) * (size_t)capacity);
+    if (!h->heap || !h->position || !h->key) {
+        free(h->heap);
+        free(h->position);
+        free(h->key);
+        free(h);
+        return NULL;
+    }
+
+    for (int id = 0; id < capacity; id++) h->position[id] = -1;
+    h->size = 0;
+    h->capacity = capacity;
+    h->arity = arity > 1 ? arity : DHEAP_DEFAULT_ARITY;
+    return h;
+}
+
+void dheap_free(DHEAP* h) {
+    if (h == NULL) return;
+    free(h->heap);
+    free(h->position);
+    free(h->key);
+    free(h);
+}
+
+int dheap_is_empty(const DHEAP* h) {
+    return h->size == 0;
+}
+
+int dheap_contains(const DHEAP* h, int id) {
+    return h->position[id] >= 0;
+}
+
+// Sobe o elemento da posição idx: os pais maiores descem para o buraco
+void dheap_sift_up(DHEAP* h, int idx) {
+    int id = h->heap[idx];
+    DHEAP_KEY k = h->key[id];
+
+    while (idx > 0) {
+        int dad = (idx - 1) / h->arity;
+        int dad_id = h->heap[dad];
+        if (!(k < h->key[dad_id])) break;
+
+        h->heap[idx] = dad_id; // pai desce para o buraco
+        h->position[dad_id] = idx;
+        idx = dad;             // o buraco sobe
+    }
+    h->heap[idx] = id;         // uma escrita só, na posição final
+    h->position[id] = idx;
+}
+
+// Desce o elemento da posição idx: o menor filho sobe para o buraco
+void dheap_sift_down(DHEAP* h, int idx) {
+    int id = h->heap[idx];
+    DHEAP_KEY k = h->key[id];
+
+    while (1) {
+        int first = h->arity * idx + 1;
+        if (first >= h->size) break;
+
+        int last = first + h->arity < h->size ? first + h->arity : h->size;
+        int lower = first;
+        DHEAP_KEY lower_key = h->key[h->heap[first]];
+        for (int child = first + 1; child < last; child++) { // menor dos d filhos
+            DHEAP_KEY child_key = h->key[h->heap[child]];
+            if (child_key < lower_key) {
+                lower = child;
+                lower_key = child_key;
+            }
+        }
+        if (!(lower_key < k)) break;
+
+        h->heap[idx] = h->heap[lower]; // filho sobe para o buraco
+        h->position[h->heap[idx]] = idx;
+        idx = lower;                   // o buraco desce
+    }
+    h->heap[idx] = id;
+    h->position[id] = idx;
+}
+
+// Insere id com prioridade k. Retorna 0 se o id for inválido ou já estiver na fila
+int dheap_push(DHEAP* h, int id, DHEAP_KEY k) {
+    if (id < 0 || id >= h->capacity || h->position[id] >= 0) return 0;
+
+    h->key[id] = k;
+    h->heap[h->size] = id;
+    h->position[id] = h->size;
+    h->size++;
+    dheap_sift_up(h, h->size - 1);
+    return 1;
+}
+
+// id com a menor prioridade, sem remover (-1 se vazia)
+int dheap_top(const DHEAP* h) {
+    return h->size > 0 ? h->heap[0] : -1;
+}
+
+// Remove e retorna o id com a menor prioridade (-1 se vazia)
+int dheap_pop(DHEAP* h) {
+    if (h->size == 0) return -1;
+
+    int min = h->heap[0];
+    h->position[min] = -1;
+    h->size--;
+    if (h->size > 0) {
+        h->heap[0] = h->heap[h->size]; // o último vai para a raiz e desce
+        dheap_sift_down(h, 0);
+    }
+    return min;
+}
+
+// Tira id da fila, esteja onde estiver
+void dheap_remove(DHEAP* h, int id) {
+    int idx = h->position[id];
+    if (idx < 0) return;
+
+    h->position[id] = -1;
+    h->size--;
+    if (idx == h->size) return; // era o último
+
+    int moved = h->heap[h->size]; // o último ocupa o lugar e vai para cima ou para baixo
+    h->heap[idx] = moved;
+    h->position[moved] = idx;
+    dheap_sift_up(h, idx);
+    dheap_sift_down(h, h->position[moved]);
+}
+
+// Prioridade de id diminuiu (sai mais cedo): só pode subir
+void dheap_decrease_key(DHEAP* h, int id, DHEAP_KEY k) {
+    h->key[id] = k;
+    if (h->position[id] >= 0) dheap_sift_up(h, h->position[id]);
+}
+
+// Prioridade de id aumentou (sai mais tarde): só pode descer
+void dheap_increase_key(DHEAP* h, int id, DHEAP_KEY k) {
+    h->key[id] = k;
+    if (h->position[id] >= 0) dheap_sift_down(h, h->position[id]);
+}
+
+// Muda a prioridade sem saber se aumentou ou diminuiu (insere se id não estiver na fila)
+void dheap_update(DHEAP* h, int id, DHEAP_KEY k) {
+    if (h->position[id] < 0) {
+        dheap_push(h, id, k);
+        return;
+    }
+    DHEAP_KEY old = h->key[id];
+    if (k < old) dheap_decrease_key(h, id, k);
+    else dheap_increase_key(h, id, k);
+}
+
+/*Substitui o conteúdo da fila por ids[0..n-1] com prioridades keys[0..n-1], em O(n):
+coloca todos no vetor e desce cada nó interno, do último para a raiz.
+Retorna 0 se algum id for inválido ou repetido (a fila fica vazia).*/
+int dheap_build(DHEAP* h, const int* ids, const DHEAP_KEY* keys, int n) {
+    for (int i = 0; i < h->size; i++) h->position[h->heap[i]] = -1;
+    h->size = 0;
+
+    for (int i = 0; i < n; i++) {
+        int id = ids[i];
+        if (id < 0 || id >= h->capacity || h->position[id] >= 0) {
+            for (int j = 0; j < i; j++) h->position[ids[j]] = -1;
+            return 0;
+        }
+        h->key[id] = keys[i];
+        h->heap[i] = id;
+        h->position[id] = i;
+    }
+    h->size = n;
+
+    // Último nó interno = pai do último elemento
+    for (int idx = n > 1 ? (n - 2) / h->arity : -1; idx >= 0; idx--) {
+        dheap_sift_down(h, idx);
+    }
+    return 1;
+}
+
+#endif // PQUEUE_DARY_HEAP_H
@@ -54,12 +54,13 @@ Com #ifndef: Cada arquivo é incluído apenas uma vez!
 #include "huffman.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #define MAX_HEAP 256 //Porque temos 256 caracteres possíveis (0-255)
 
 typedef struct NODE {
     unsigned char character; 
-    int frequency; 
+    uint64_t frequency; //64 bits: arquivos com mais de 2 GiB estouravam o int
     struct NODE *left, *right; // Filhos na árvore
 } NODE;
 
@@ -69,49 +70,62 @@ typedef struct {
 } PRIORITY_QUEUE;
 
 
-NODE* create_node(unsigned char c, int freq, NODE* left, NODE* right) { //Cria um novo nó atribuindo os parâmetros fornecidos
-    NODE* NODE = malloc(sizeof(*NODE));
-    NODE->character = c;
-    NODE->frequency = freq;
-    NODE->left = left;
-    NODE->right = right;
-    return NODE;
-}
+/*
+    POOL DE NÓS
 
-PRIORITY_QUEUE* create_queue() { // Cria uma nova fila de prioridade, menos frequencia primeiro
-    PRIORITY_QUEUE* pq = malloc(sizeof(PRIORITY_QUEUE));
-    pq->size = 0;
-    return pq;
-}
+    Antes, create_node() fazia um malloc por nó e free_huffman_tree() um free
+    por nó. Compactando milhões de arquivos pequenos, o alocador virava o
+    gargalo. Uma árvore de Huffman tem no máximo 256 folhas + 255 nós
+    internos = 511 nós, então todos cabem num único bloco fixo:
 
-// Adicione isso antes de qualquer uso da função
-void free_huffman_tree(NODE* root);
+    NODE_POOL* pool = create_node_pool();      // 1 malloc
+    NODE* a = create_node(pool, 'A', 5, NULL, NULL);  // só pega o próximo nó livre
+    ...
+    free_node_pool(pool);                      // 1 free, a árvore inteira
 
-/*
-O problema:
-O pqueue_heap.h precisa liberar memória dos nós, mas a função free_huffman_tree() está definida no huffman.h!
+    Os nós ficam lado a lado na memória, então percorrer a árvore também
+    fica mais amigável para a cache. Para reaproveitar o mesmo pool em outra
+    árvore basta reset_node_pool(pool).
+*/
 
-A solução:
+#define MAX_NODES (2 * MAX_HEAP - 1) //511
 
-void free_huffman_tree(NODE* root); <- Declaração ANTECIPADA
+typedef struct {
+    NODE nodes[MAX_NODES];
+    int used; //quantos nós já foram entregues
+} NODE_POOL;
 
-Isso diz ao compilador: "Confia em mim, essa função existe em outro lugar!"
+void reset_node_pool(NODE_POOL* pool) {
+    pool->used = 0; //libera todos os nós de uma vez
+}
 
-Por que é necessário?
-Sem essa declaração, quando o compilador vê:
+NODE_POOL* create_node_pool() {
+    NODE_POOL* pool = malloc(sizeof(NODE_POOL));
+    if (pool) reset_node_pool(pool);
+    return pool;
+}
 
-free_huffman_tree(pq->data[i]);  ← no free_priority_queue()
-Ele pensa: "Que função é essa? Nunca vi!" → ERRO!
+void free_node_pool(NODE_POOL* pool) {
+    free(pool);
+}
 
-Fluxo correto:
+//Cria um novo nó atribuindo os parâmetros fornecidos. Retorna NULL se o pool estiver cheio (árvore inválida)
+NODE* create_node(NODE_POOL* pool, unsigned char c, uint64_t freq, NODE* left, NODE* right) {
+    if (pool->used == MAX_NODES) return NULL;
 
-Compilação:
-1. Vê void free_huffman_tree(NODE* root); → "Ok, existe em algum lugar"
-2. Vê free_huffman_tree(pq->data[i]) → "Ah, é aquela que prometeram!"
-3. Na ligação (linking): Encontra a implementação real no huffman.h
+    NODE* node = &pool->nodes[pool->used++];
+    node->character = c;
+    node->frequency = freq;
+    node->left = left;
+    node->right = right;
+    return node;
+}
 
-Essa declaração antecipada resolve o problema da dependência circular entre os arquivos!
-*/
+PRIORITY_QUEUE* create_queue() { // Cria uma nova fila de prioridade, menos frequencia primeiro
+    PRIORITY_QUEUE* pq = malloc(sizeof(PRIORITY_QUEUE));
+    pq->size = 0;
+    return pq;
+}
 
 int is_empty(PRIORITY_QUEUE* pq) {
     return pq->size == 0; //Fila vazia
@@ -204,10 +218,7 @@ NODE* remove_lower(PRIORITY_QUEUE* pq) {
 void free_priority_queue(PRIORITY_QUEUE* pq) {
     if (pq == NULL) return;
 
-    for (int i = 0; i < pq->size; i++) {
-        free_huffman_tree(pq->data[i]); // Libera cada nó na fila
-    }
-    free(pq); // Liberte a estrutura da fila
+    free(pq); // Liberte a estrutura da fila (os nós pertencem ao NODE_POOL e saem com free_node_pool)
 }
 
 
@@ -231,16 +242,19 @@ Retorna: [data: [NULL, NULL, ...], size: 0]
      ↓
 PRIORITY_QUEUE* huff_queue2 = create_queue()
 // Cria segunda fila IDÊNTICA
+     ↓
+NODE_POOL* pool = create_node_pool()
+// Um bloco com espaço para os 511 nós da árvore
 
 
 FASE 2: ANÁLISE DE FREQUÊNCIA 
 
-main.c → create_huff_queue(original_file, &huff_queue1, &huff_queue2)
+main.c → create_huff_queue(original_file, &huff_queue1, &huff_queue2, pool)
      ↓
 Para cada caractere no arquivo:
      ↓
-NODE* node = create_node(i, freq[i], NULL, NULL)
-// create_node() aloca: [character: 'A', frequency: 5, left: NULL, right: NULL]
+NODE* node = create_node(pool, i, freq[i], NULL, NULL)
+// create_node() pega o próximo nó do pool: [character: 'A', frequency: 5, left: NULL, right: NULL]
      ↓
 insert(*pq1, node) e insert(*pq2, node)
      ↓
@@ -252,7 +266,7 @@ Dentro do insert():
 
 FASE 3: CONSTRUÇÃO DA ÁRVORE HUFFMAN 
 text
-main.c → build_huffman_tree(huff_queue1)
+main.c → build_huffman_tree(huff_queue1, pool)
      ↓
 Enquanto huff_queue1->size > 1:
      ↓
@@ -265,7 +279,7 @@ NODE* left = remove_lower(huff_queue1)
      ↓
 NODE* right = remove_lower(huff_queue1)  // Segundo menor
      ↓
-NODE* parent = create_node('\0', left->freq + right->freq, left, right)
+NODE* parent = create_node(pool, '\0', left->freq + right->freq, left, right)
      ↓  
 insert(huff_queue1, parent)  // Volta para a fila
 // REPETE até sobrar 1 nó (a raiz)
@@ -285,10 +299,11 @@ bit_amount += node->frequency * huff_table[node->character].
 
 FASE 5: LIMPEZA 
 text
+main.c → free_node_pool(pool)
+     ↓
+free(pool)  // Libera TODOS os nós da árvore de uma vez
+     ↓
 main.c → free_priority_queue(huff_queue1)
      ↓
-Dentro free_priority_queue:
-for (i = 0; i < pq->size; i++)
-    free_huffman_tree(pq->data[i])  // Libera cada nó
 free(pq)  // Libera a estrutura da fila
 */